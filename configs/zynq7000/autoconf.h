@@ -75,6 +75,7 @@
 #define CONFIG_USER_OPTIMISATION_O2 1
 #define CONFIG_LIB_CPIO 1
 #define CONFIG_RETYPE_FAN_OUT_LIMIT 256
+#define CONFIG_ARM_L2_WAY_MAINTENANCE_THRESHOLD 1024
 #define CONFIG_ROOT_CNODE_SIZE_BITS 12
 #define CONFIG_NUM_PRIORITIES 256
 #define CONFIG_TESTPRINTER_REGEX ".*"
@@ -113,6 +113,11 @@ debug_printTCB(tcb_t *tcb)
     case ThreadState_RunningVM:
         state = "running VM";
         break;
+#endif
+#ifdef CONFIG_KERNEL_TIMEOUTS
+    case ThreadState_BlockedOnTimeout:
+        state = "sleeping";
+        break;
 #endif
     case ThreadState_IdleThreadState:
         state = "idle";
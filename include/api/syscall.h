@@ -35,6 +35,18 @@ getSyscallArg(word_t i, word_t* ipc_buffer)
     return ipc_buffer[i + 1];
 }
 
+static inline void
+setSyscallArg(word_t i, word_t* ipc_buffer, word_t value)
+{
+    if (i < n_msgRegisters) {
+        setRegister(NODE_STATE(ksCurThread), msgRegisters[i], value);
+        return;
+    }
+
+    assert(ipc_buffer != NULL);
+    ipc_buffer[i + 1] = value;
+}
+
 extern extra_caps_t current_extra_caps;
 
 #endif
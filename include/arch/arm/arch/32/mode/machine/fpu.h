@@ -135,6 +135,16 @@ static inline void loadFpuState(user_fpu_state_t *src)
     MCR(FPEXC, src->fpexc);
 }
 
+/* Copy FPU state supplied by user level into a thread's saved state. FPEXC
+ * controls the kernel's own handling of the FPU, so it is kept as it was. */
+static inline void Arch_setFpuState(user_fpu_state_t *dest, const void *src)
+{
+    uint32_t fpexc = dest->fpexc;
+
+    memcpy(dest, src, sizeof(*dest));
+    dest->fpexc = fpexc;
+}
+
 #endif /* CONFIG_HAVE_FPU */
 
 /* Disable the FPU so that usage of it causes a fault */
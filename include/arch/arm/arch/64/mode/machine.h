@@ -84,6 +84,19 @@ static inline word_t readTPIDRURW(void)
     return reg;
 }
 
+static inline word_t readTranslationControlRegister(void)
+{
+    word_t tcr;
+    MRS("tcr_el1", tcr);
+    return tcr;
+}
+
+static inline void writeTranslationControlRegister(word_t tcr)
+{
+    MSR("tcr_el1", tcr);
+    isb();
+}
+
 static inline void setCurrentKernelVSpaceRoot(ttbr_t ttbr)
 {
     dsb();
@@ -136,6 +149,20 @@ static inline void invalidateLocalTLB_VAASID(word_t mva_plus_asid)
     isb();
 }
 
+/* Invalidate count consecutive entries, step apart, on every core in the
+ * inner shareable domain, with one barrier for the lot */
+static inline void invalidateTLB_VAASIDRange_IS(word_t mva_plus_asid, word_t count, word_t step)
+{
+    word_t i;
+
+    dsb();
+    for (i = 0; i < count; i++) {
+        asm volatile("tlbi vae1is, %0" : : "r" (mva_plus_asid + i * step));
+    }
+    dsb();
+    isb();
+}
+
 void lockTLBEntry(vptr_t vaddr);
 
 static inline void cleanByVA(vptr_t vaddr, paddr_t paddr)
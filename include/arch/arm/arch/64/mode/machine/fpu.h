@@ -86,6 +86,12 @@ static inline void loadFpuState(user_fpu_state_t *src)
     );
 }
 
+/* Copy FPU state supplied by user level into a thread's saved state. */
+static inline void Arch_setFpuState(user_fpu_state_t *dest, const void *src)
+{
+    memcpy(dest, src, sizeof(*dest));
+}
+
 /* Enable the FPU to be used without faulting.
  * Required even if the kernel attempts to use the FPU. */
 static inline void enableFpu(void)
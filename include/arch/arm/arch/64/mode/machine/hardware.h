@@ -18,6 +18,9 @@
 
 #define PAGE_BITS seL4_PageBits
 
+/* TLB maintenance by address takes VA[55:12], whatever the granule */
+#define TLBI_VADDR_SHIFT 12
+
 #if defined(CONFIG_ARM_CORTEX_A53)
 #define L1_CACHE_LINE_SIZE_BITS  6 /* 64 bytes */
 #endif
@@ -39,6 +42,13 @@
 #define CONTROL_E0E       24 /* Endianness of data accesses at EL0 */
 #define CONTROL_EE        25 /* Endianness of data accesses at EL1 */
 
+/* Translation control register fields */
+#define TCR_TG0_SHIFT     14 /* Granule size for TTBR0 */
+#define TCR_TG0_MASK      (3ul << TCR_TG0_SHIFT)
+#define TCR_TG0_64K       (1ul << TCR_TG0_SHIFT)
+#define TCR_HA            (1ul << 39) /* Hardware access flag update */
+#define TCR_HD            (1ul << 40) /* Hardware dirty state management */
+
 #ifndef __ASSEMBLER__
 
 #include <arch/types.h>
@@ -25,10 +25,10 @@ extern asid_pool_t *armKSASIDTable[BIT(asidHighBits)] VISIBLE;
 /* This is the temporary userspace page table in kernel. It is required before running
  * user thread to avoid speculative page table walking with the wrong page table. */
 extern pgde_t armKSGlobalUserPGD[BIT(PGD_INDEX_BITS)] VISIBLE;
-extern pgde_t armKSGlobalKernelPGD[BIT(PGD_INDEX_BITS)] VISIBLE;
+extern pgde_t armKSGlobalKernelPGD[BIT(KERNEL_TABLE_INDEX_BITS)] VISIBLE;
 
-extern pude_t armKSGlobalKernelPUD[BIT(PUD_INDEX_BITS)] VISIBLE;
-extern pde_t armKSGlobalKernelPDs[BIT(PUD_INDEX_BITS)][BIT(PD_INDEX_BITS)] VISIBLE;
-extern pte_t armKSGlobalKernelPT[BIT(PT_INDEX_BITS)] VISIBLE;
+extern pude_t armKSGlobalKernelPUD[BIT(KERNEL_TABLE_INDEX_BITS)] VISIBLE;
+extern pde_t armKSGlobalKernelPDs[BIT(KERNEL_TABLE_INDEX_BITS)][BIT(KERNEL_TABLE_INDEX_BITS)] VISIBLE;
+extern pte_t armKSGlobalKernelPT[BIT(KERNEL_TABLE_INDEX_BITS)] VISIBLE;
 
 #endif /* __ARCH_MODEL_STATEDATA_64_H */
@@ -208,7 +208,9 @@ tagged_union pde pde_type {
 block pte {
     padding                         9
     field UXN                       1
-    padding                         6
+    padding                         1
+    field contiguous                1
+    padding                         4
     field_high page_base_address    36
     field nG                        1
     field AF                        1
@@ -56,6 +56,33 @@ typedef pgde_t vspace_root_t;
 #define GET_PD_INDEX(x)     (((x) >> (PD_INDEX_OFFSET)) & MASK(PD_INDEX_BITS))
 #define GET_PT_INDEX(x)     (((x) >> (PT_INDEX_OFFSET)) & MASK(PT_INDEX_BITS))
 
+/* An aligned run of this many PTEs that map one physically contiguous,
+ * equally aligned region with identical attributes may set the contiguous
+ * hint, letting the TLB hold the whole run in a single entry */
+#ifdef CONFIG_ARM_USER_64K_GRANULE
+#define PT_CONTIGUOUS_BITS  5
+#else
+#define PT_CONTIGUOUS_BITS  4
+#endif
+
+/* The kernel window is translated through TTBR1 with the 4K granule set up
+ * by the elfloader, whatever granule user address spaces use */
+#define KERNEL_PAGE_BITS            12
+#define KERNEL_LARGE_PAGE_BITS      21
+#define KERNEL_HUGE_PAGE_BITS       30
+#define KERNEL_TABLE_INDEX_BITS     9
+#define KERNEL_TABLE_BITS           (KERNEL_TABLE_INDEX_BITS + PTE_SIZE_BITS)
+
+#define KERNEL_PT_INDEX_OFFSET      KERNEL_PAGE_BITS
+#define KERNEL_PD_INDEX_OFFSET      (KERNEL_PT_INDEX_OFFSET + KERNEL_TABLE_INDEX_BITS)
+#define KERNEL_PUD_INDEX_OFFSET     (KERNEL_PD_INDEX_OFFSET + KERNEL_TABLE_INDEX_BITS)
+#define KERNEL_PGD_INDEX_OFFSET     (KERNEL_PUD_INDEX_OFFSET + KERNEL_TABLE_INDEX_BITS)
+
+#define GET_KERNEL_PGD_INDEX(x) (((x) >> KERNEL_PGD_INDEX_OFFSET) & MASK(KERNEL_TABLE_INDEX_BITS))
+#define GET_KERNEL_PUD_INDEX(x) (((x) >> KERNEL_PUD_INDEX_OFFSET) & MASK(KERNEL_TABLE_INDEX_BITS))
+#define GET_KERNEL_PD_INDEX(x)  (((x) >> KERNEL_PD_INDEX_OFFSET) & MASK(KERNEL_TABLE_INDEX_BITS))
+#define GET_KERNEL_PT_INDEX(x)  (((x) >> KERNEL_PT_INDEX_OFFSET) & MASK(KERNEL_TABLE_INDEX_BITS))
+
 #define PGDE_PTR(r)         ((pgde_t *)(r))
 #define PGDE_PTR_PTR(r)     ((pgde_t **)(r))
 #define PGDE_REF(p)         ((word_t)(p))
@@ -51,6 +51,28 @@ exception_t decodeARMMMUInvocation(word_t invLabel, word_t length, cptr_t cptr,
                                    cte_t *cte, cap_t cap, extra_caps_t excaps,
                                    word_t *buffer);
 
+/* Whether cap is a frame of normal memory that its holder may write to, or
+ * only read from if write is false */
+static inline bool_t
+Arch_isUserAccessibleFrame(cap_t cap, bool_t write)
+{
+    vm_rights_t rights;
+
+#ifdef CONFIG_ARCH_AARCH64
+    if (cap_get_capType(cap) != cap_frame_cap || cap_frame_cap_get_capFIsDevice(cap)) {
+        return false;
+    }
+    rights = cap_frame_cap_get_capFVMRights(cap);
+#else
+    if ((cap_get_capType(cap) != cap_small_frame_cap && cap_get_capType(cap) != cap_frame_cap) ||
+            generic_frame_cap_get_capFIsDevice(cap)) {
+        return false;
+    }
+    rights = generic_frame_cap_get_capFVMRights(cap);
+#endif
+    return rights == VMReadWrite || (!write && rights == VMReadOnly);
+}
+
 #ifdef CONFIG_PRINTING
 void Arch_userStackTrace(tcb_t *tptr);
 #endif
@@ -11,6 +11,22 @@
 #ifndef __ARCH_MACHINE_CAPDL_H
 #define __ARCH_MACHINE_CAPDL_H
 
+#include <object/structures.h>
+
 void capDL(void);
 
+/* Whether a cap is a frame that a snapshot image can be written into */
+static inline bool_t
+Arch_isCapDLSnapshotFrame(cap_t cap)
+{
+#ifdef CONFIG_ARCH_AARCH64
+    return cap_get_capType(cap) == cap_frame_cap &&
+           !cap_frame_cap_get_capFIsDevice(cap);
+#else
+    return (cap_get_capType(cap) == cap_small_frame_cap ||
+            cap_get_capType(cap) == cap_frame_cap) &&
+           !generic_frame_cap_get_capFIsDevice(cap);
+#endif
+}
+
 #endif
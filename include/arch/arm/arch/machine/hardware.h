@@ -14,6 +14,10 @@
 #include <config.h>
 #include <mode/machine/hardware.h>
 
+/* Platform device regions are listed in frames of this size, whatever the
+ * page size of user address spaces */
+#define DEVICE_FRAME_BITS 12
+
 #ifndef __ASSEMBLER__
 enum vm_fault_type {
     ARMDataAbort = seL4_DataFault,
@@ -15,22 +15,26 @@
 
 #include <mode/machine.h>
 #include <arch/smp/ipi_inline.h>
+#include <model/kernel_stats.h>
 
 static inline void invalidateTranslationSingle(vptr_t vptr)
 {
     invalidateLocalTLB_VAASID(vptr);
+    SMP_COND_STATEMENT(KERNEL_STATS_SHOOTDOWN(MASK(CONFIG_MAX_NUM_NODES)));
     SMP_COND_STATEMENT(doRemoteInvalidateTranslationSingle(vptr, MASK(CONFIG_MAX_NUM_NODES)));
 }
 
 static inline void invalidateTranslationASID(hw_asid_t hw_asid)
 {
     invalidateLocalTLB_ASID(hw_asid);
+    SMP_COND_STATEMENT(KERNEL_STATS_SHOOTDOWN(MASK(CONFIG_MAX_NUM_NODES)));
     SMP_COND_STATEMENT(doRemoteInvalidateTranslationASID(hw_asid, MASK(CONFIG_MAX_NUM_NODES)));
 }
 
 static inline void invalidateTranslationAll(void)
 {
     invalidateLocalTLB();
+    SMP_COND_STATEMENT(KERNEL_STATS_SHOOTDOWN(MASK(CONFIG_MAX_NUM_NODES)));
     SMP_COND_STATEMENT(doRemoteInvalidateTranslationAll(MASK(CONFIG_MAX_NUM_NODES)));
 }
 
@@ -522,7 +522,8 @@ block asid_map_vspace {
 #ifdef CONFIG_VTX
 block asid_map_ept {
     field_high ept_root             20
-    padding                         10
+    padding                         9
+    field accessed_dirty            1
     field type                      2
 }
 #endif
@@ -36,12 +36,14 @@ static inline void invalidateLocalASID(vspace_root_t *vspace, asid_t asid)
 static inline void invalidatePCID(word_t type, void *vaddr, asid_t asid, word_t mask)
 {
     invalidateLocalPCID(type, vaddr, asid);
+    SMP_COND_STATEMENT(KERNEL_STATS_SHOOTDOWN(mask));
     SMP_COND_STATEMENT(doRemoteInvalidatePCID(type, vaddr, asid, mask));
 }
 
 static inline void invalidateASID(vspace_root_t *vspace, asid_t asid, word_t mask)
 {
     invalidateLocalASID(vspace, asid);
+    SMP_COND_STATEMENT(KERNEL_STATS_SHOOTDOWN(mask));
     SMP_COND_STATEMENT(doRemoteInvalidateASID(vspace, asid, mask));
 }
 
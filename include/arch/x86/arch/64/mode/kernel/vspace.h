@@ -72,4 +72,7 @@ x86_make_empty_root_mapping(void)
            );
 }
 
+exception_t decodeX86HarvestStatusBits(word_t invLabel, word_t length, cap_t cap,
+                                       extra_caps_t excaps, word_t *buffer);
+
 #endif /* __MODE_KERNEL_VSPACE_H */
@@ -425,7 +425,8 @@ block asid_map_vspace {
 #ifdef CONFIG_VTX
 block asid_map_ept {
     field_high ept_root             48
-    padding                         14
+    padding                         13
+    field accessed_dirty            1
     field type                      2
 }
 #endif
@@ -41,7 +41,10 @@ bool_t init_sys_state(
     paddr_t*      drhu_list,
     acpi_rmrr_list_t *rmrr_list,
     seL4_X86_BootInfo_VBE *vbe,
-    seL4_X86_BootInfo_mmap_t *mb_mmap
+    seL4_X86_BootInfo_mmap_t *mb_mmap,
+    acpi_numa_info_t *numa_info,
+    seL4_X86_BootInfo_NUMA *numa_bi,
+    seL4_X86_BootInfo_Modules *modules_bi
 );
 
 bool_t init_cpu(
@@ -15,6 +15,7 @@
 
 #include <config.h>
 #include <object/structures.h>
+#include <arch/kernel/vspace.h>
 
 #ifdef CONFIG_VTX
 
@@ -42,6 +43,8 @@ typedef struct EPTPageTableMapped_ret EPTPageTableMapped_ret_t;
 struct findEPTForASID_ret {
     exception_t status;
     ept_pml4e_t *ept;
+    /* whether the EPT is walked with accessed and dirty flags */
+    bool_t accessedDirty;
 };
 typedef struct findEPTForASID_ret findEPTForASID_ret_t;
 
@@ -60,6 +63,8 @@ void unmapEPTPDPT(asid_t asid, vptr_t vaddr, ept_pdpte_t *pdpt);
 void unmapEPTPageDirectory(asid_t asid, vptr_t vaddr, ept_pde_t *pd);
 void unmapEPTPageTable(asid_t asid, vptr_t vaddr, ept_pte_t *pt);
 void unmapEPTPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, void *pptr);
+harvestStatus_ret_t eptHarvestStatusBits(ept_pml4e_t *pml4, vptr_t vaddr, word_t flags);
+void eptEnableAccessedDirty(asid_t asid);
 
 #endif /* CONFIG_VTX */
 
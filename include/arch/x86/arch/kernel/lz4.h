@@ -0,0 +1,28 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the GNU General Public License version 2. Note that NO WARRANTY is provided.
+ * See "LICENSE_GPLv2.txt" for details.
+ *
+ * @TAG(DATA61_GPL)
+ */
+
+#ifndef __ARCH_KERNEL_LZ4_H_
+#define __ARCH_KERNEL_LZ4_H_
+
+#include <config.h>
+#include <types.h>
+
+#ifdef CONFIG_BOOT_MODULE_LZ4
+
+/* minimal LZ4 frame decoder for compressed GRUB boot modules */
+bool_t lz4_checkFrame(void *src, word_t src_len);
+uint64_t lz4_getContentSize(void *src, word_t src_len);
+word_t lz4_decompress(void *src, word_t src_len, void *dst, word_t dst_len);
+
+#endif /* CONFIG_BOOT_MODULE_LZ4 */
+
+#endif /* __ARCH_KERNEL_LZ4_H_ */
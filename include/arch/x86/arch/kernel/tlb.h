@@ -14,6 +14,7 @@
 #define __ARCH_KERNEL_TLB_H
 
 #include <arch/smp/ipi_inline.h>
+#include <model/kernel_stats.h>
 
 static inline void invalidatePageStructureCacheASID(paddr_t root, asid_t asid, word_t mask)
 {
@@ -24,18 +25,21 @@ static inline void invalidatePageStructureCacheASID(paddr_t root, asid_t asid, w
 static inline void invalidateTranslationSingle(vptr_t vptr, word_t mask)
 {
     invalidateLocalTranslationSingle(vptr);
+    SMP_COND_STATEMENT(KERNEL_STATS_SHOOTDOWN(mask));
     SMP_COND_STATEMENT(doRemoteInvalidateTranslationSingle(vptr, mask));
 }
 
 static inline void invalidateTranslationSingleASID(vptr_t vptr, asid_t asid, word_t mask)
 {
     invalidateLocalTranslationSingleASID(vptr, asid);
+    SMP_COND_STATEMENT(KERNEL_STATS_SHOOTDOWN(mask));
     SMP_COND_STATEMENT(doRemoteInvalidateTranslationSingleASID(vptr, asid, mask));
 }
 
 static inline void invalidateTranslationAll(word_t mask)
 {
     invalidateLocalTranslationAll();
+    SMP_COND_STATEMENT(KERNEL_STATS_SHOOTDOWN(mask));
     SMP_COND_STATEMENT(doRemoteInvalidateTranslationAll(mask));
 }
 
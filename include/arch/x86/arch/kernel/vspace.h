@@ -38,6 +38,42 @@ struct findVSpaceForASID_ret {
 };
 typedef struct findVSpaceForASID_ret findVSpaceForASID_ret_t;
 
+#ifdef CONFIG_FRAME_DONATION
+struct donateFrame_ret {
+    bool_t donated;
+    cap_t  cap;
+    vptr_t vaddr;
+};
+typedef struct donateFrame_ret donateFrame_ret_t;
+#endif
+
+/* Status bits selected by the flags of a HarvestStatusBits invocation, as in
+ * libsel4's seL4_X86_StatusBits */
+#define X86_STATUS_ACCESSED     BIT(0)
+#define X86_STATUS_DIRTY        BIT(1)
+
+/* The flags bits from this one up hold the page a preempted HarvestStatusBits
+ * continues from. They are zero when the invocation is first made. */
+#define X86_STATUS_RESUME_SHIFT 8
+
+/* Result of harvesting the status bits at an address: the number of pages from
+ * that address to the end of the mapping or unmapped region holding it, and
+ * whether any of the selected bits were set */
+struct harvestStatus_ret {
+    word_t pages;
+    bool_t mapped;
+    bool_t set;
+};
+typedef struct harvestStatus_ret harvestStatus_ret_t;
+
+/* Clears the bits of mask in a paging structure entry, which the processor
+ * may be updating concurrently, and returns whether any were set */
+static inline bool_t
+testAndClearEntryBits(uint64_t *entry, uint64_t mask)
+{
+    return !!(__atomic_fetch_and(entry, ~mask, __ATOMIC_RELAXED) & mask);
+}
+
 void init_boot_pd(void);
 void enable_paging(void);
 bool_t map_kernel_window(
@@ -102,6 +138,9 @@ bool_t CONST isValidNativeRoot(cap_t cap);
 exception_t checkValidIPCBuffer(vptr_t vptr, cap_t cap);
 vm_rights_t CONST maskVMRights(vm_rights_t vm_rights, seL4_CapRights_t cap_rights_mask);
 void flushTable(vspace_root_t *vspace, word_t vptr, pte_t *pt, asid_t asid);
+#ifdef CONFIG_FRAME_DONATION
+donateFrame_ret_t Arch_donateFrame(cap_t cap, tcb_t *receiver);
+#endif
 
 exception_t decodeX86MMUInvocation(word_t invLabel, word_t length, cptr_t cptr, cte_t *cte,
                                    cap_t cap, extra_caps_t excaps, word_t *buffer);
@@ -139,4 +178,18 @@ checkVPAlignment(vm_page_size_t sz, word_t w)
     return IS_ALIGNED(w, pageBitsForSize(sz));
 }
 
+/* Whether cap is a frame of normal memory that its holder may write to, or
+ * only read from if write is false */
+static inline bool_t
+Arch_isUserAccessibleFrame(cap_t cap, bool_t write)
+{
+    vm_rights_t rights;
+
+    if (cap_get_capType(cap) != cap_frame_cap || cap_frame_cap_get_capFIsDevice(cap)) {
+        return false;
+    }
+    rights = cap_frame_cap_get_capFVMRights(cap);
+    return rights == VMReadWrite || (!write && rights == VMReadOnly);
+}
+
 #endif
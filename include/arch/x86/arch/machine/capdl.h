@@ -11,6 +11,16 @@
 #ifndef __ARCH_MACHINE_CAPDL_H
 #define __ARCH_MACHINE_CAPDL_H
 
+#include <object/structures.h>
+
 void capDL(void);
 
+/* Whether a cap is a frame that a snapshot image can be written into */
+static inline bool_t
+Arch_isCapDLSnapshotFrame(cap_t cap)
+{
+    return cap_get_capType(cap) == cap_frame_cap &&
+           !cap_frame_cap_get_capFIsDevice(cap);
+}
+
 #endif
@@ -93,6 +93,26 @@ static inline void loadFpuState(user_fpu_state_t *src)
     }
 }
 
+/* Copy FPU state supplied by user level into a thread's saved state, clearing
+ * anything that would make the restore instruction fault in the kernel. */
+static inline void Arch_setFpuState(user_fpu_state_t *dest, const void *src)
+{
+    xsave_state_t *state = (xsave_state_t *)dest;
+
+    memcpy(dest, src, sizeof(*dest));
+    state->i387.mxcsr &= 0xffbf;
+    if (config_set(CONFIG_XSAVE)) {
+        state->header.xfeatures &= config_ternary(CONFIG_XSAVE, CONFIG_XSAVE_FEATURE_SET, 1);
+        if (config_set(CONFIG_XSAVE_XSAVEC) || config_set(CONFIG_XSAVE_XSAVES)) {
+            state->header.xcomp_bv = XCOMP_BV_COMPACTED_FORMAT |
+                                     config_ternary(CONFIG_XSAVE, CONFIG_XSAVE_FEATURE_SET, 1);
+        } else {
+            state->header.xcomp_bv = 0;
+        }
+        memzero(state->header.reserved, sizeof(state->header.reserved));
+    }
+}
+
 /* Reset the FPU registers into their initial blank state. */
 static inline void finit(void)
 {
@@ -68,6 +68,7 @@ extern user_fpu_state_t x86KSnullFpuState ALIGN(MIN_FPU_ALIGNMENT);
 extern uint32_t x86KSnumDrhu;
 extern vtd_rte_t* x86KSvtdRootTable;
 extern uint32_t x86KSnumIOPTLevels;
+extern uint32_t x86KSnumIOSuperPageLevels;
 extern uint32_t x86KSnumIODomainIDBits;
 extern uint32_t x86KSFirstValidIODomain;
 
@@ -301,7 +301,7 @@ struct vcpu {
     word_t cached_cr0_mask;
     word_t cached_cr0;
 
-    /* Last used EPT root */
+    /* Last used EPT pointer, including the root and its flags */
     word_t last_ept_root;
 
     /* Last set host cr3 */
@@ -353,6 +353,9 @@ void VMCheckBoundNotification(tcb_t *tcb);
 
 void invept(ept_pml4e_t *ept_pml4);
 
+/* Whether the processor maintains accessed and dirty flags in the EPT */
+bool_t vtx_ept_ad_enabled(void);
+
 /* Removes any IO port mappings that have been cached for the given VPID */
 void clearVPIDIOPortMappings(vpid_t vpid, uint16_t first, uint16_t last);
 
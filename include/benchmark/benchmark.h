@@ -49,7 +49,10 @@ trace_point_stop(word_t id)
             ksStarted[id] = false;
             if (likely(ksLogIndex < MAX_LOG_SIZE)) {
                 ksLog[ksLogIndex] = (benchmark_tracepoint_log_entry_t) {
-                    id, ksExit - ksEntries[id]
+                    id, ksExit - ksEntries[id],
+#ifdef CONFIG_THREAD_REGISTRY
+                    NODE_STATE(ksCurThread)->tcbTag
+#endif
                 };
             }
             /* increment the log index even if we have exceeded the log size
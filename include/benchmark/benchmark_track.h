@@ -51,6 +51,28 @@ benchmark_track_start(void)
 {
     ksEnter = timestamp();
 }
+
+#ifdef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG
+/* Entries that take longer than this are captured by the watchdog */
+extern timestamp_t ksWatchdogThreshold;
+
+/**
+ * @brief Clear the captured entries of all cores and set a new threshold
+ *
+ * @param threshold New threshold, or 0 to keep the current one
+ */
+void benchmark_watchdog_reset(timestamp_t threshold);
+
+/**
+ * @brief Copy watchdog entries of a core into the IPC buffer
+ *
+ * @param node Core to read the entries of
+ * @param table benchmark_watchdog_table to read
+ * @param first Index of the first entry of the table to copy
+ * @return The number of entries copied, or an error
+ */
+exception_t benchmark_watchdog_dump(word_t node, word_t table, word_t first);
+#endif /* CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG */
 #endif /* CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES */
 
 static inline void
@@ -61,6 +61,43 @@ static inline void benchmark_utilisation_kentry_stamp(void)
     ksEnter = timestamp();
 }
 
+/* Charge the time since the last kernel exit to the current thread as user
+ * time, and charge this entry to it until told otherwise. Called once ksEnter
+ * has been stamped */
+static inline void benchmark_utilisation_kentry(void)
+{
+    tcb_t *thread = NODE_STATE(ksCurThread);
+
+    if (likely(benchmark_log_utilisation_enabled) &&
+            likely(ksEnter > NODE_STATE(ksBenchmarkExitTime))) {
+        thread->benchmark.user_time += ksEnter - NODE_STATE(ksBenchmarkExitTime);
+    }
+
+    NODE_STATE(ksBenchmarkEntryThread) = thread;
+    NODE_STATE(ksBenchmarkEntryCause) = BENCHMARK_KERNEL_TIME_FAULT;
+}
+
+/* Record what the current kernel entry is for */
+static inline void benchmark_utilisation_kentry_cause(word_t cause)
+{
+    NODE_STATE(ksBenchmarkEntryCause) = cause;
+}
+
+/* Charge the time spent in the kernel to the thread that entered it. A TCB
+ * deleted during the entry is at worst a zombie here, as its memory cannot
+ * be retyped until a later entry */
+static inline void benchmark_utilisation_kexit(void)
+{
+    timestamp_t now = timestamp();
+
+    if (likely(benchmark_log_utilisation_enabled) && likely(now > ksEnter)) {
+        NODE_STATE(ksBenchmarkEntryThread)->benchmark.kernel_time[NODE_STATE(ksBenchmarkEntryCause)] +=
+            now - ksEnter;
+    }
+
+    NODE_STATE(ksBenchmarkExitTime) = now;
+}
+
 /* Add the time between the last thread got scheduled and when to stop
  * benchmarks
  */
@@ -15,11 +15,14 @@
 
 #include <config.h>
 #include <arch/benchmark.h>
+#include <benchmark/benchmark_utilisation_types.h>
 
 #ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
 typedef struct {
     timestamp_t schedule_start_time;
     uint64_t    utilisation;
+    uint64_t    user_time;
+    uint64_t    kernel_time[BENCHMARK_KERNEL_TIME_NUM_CAUSES];
 } benchmark_util_t;
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
 
@@ -74,6 +74,15 @@
 #define CONFIG_MAX_NUM_TRACE_POINTS 0
 #endif
 
+/* default latency threshold and per core capture size of the kernel entry watchdog */
+#ifndef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG_THRESHOLD
+#define CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG_THRESHOLD 100000
+#endif
+
+#ifndef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG_ENTRIES
+#define CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG_ENTRIES 16
+#endif
+
 /* maximum number of IOMMU RMRR entries we can record while ACPI parsing */
 #ifndef CONFIG_MAX_RMRR_ENTRIES
 #define CONFIG_MAX_RMRR_ENTRIES 32
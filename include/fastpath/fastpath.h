@@ -11,21 +11,29 @@
 #ifndef __FASTPATH_H
 #define __FASTPATH_H
 
-/* Fastpath cap lookup.  Returns a null_cap on failure. */
-static inline cap_t FORCE_INLINE
-lookup_fp(cap_t cap, cptr_t cptr)
+/* Fastpath slot lookup.  Returns NULL on failure. */
+static inline cte_t * FORCE_INLINE
+lookup_slot_fp(cte_t *root, cptr_t cptr)
 {
     word_t cptr2;
     cte_t *slot;
+    cap_t cap;
     word_t guardBits, radixBits, bits;
     word_t radix, capGuard;
 
     bits = 0;
+    cap = root->cap;
 
     if (unlikely(! cap_capType_equals(cap, cap_cnode_cap))) {
-        return cap_null_cap_new();
+        return NULL;
     }
 
+#ifdef CONFIG_ASYNC_REVOKE
+    if (unlikely(mdb_node_get_mdbRevoking(root->cteMDBNode))) {
+        return NULL;
+    }
+#endif
+
     do {
         guardBits = cap_cnode_cap_get_capCNodeGuardSize(cap);
         radixBits = cap_cnode_cap_get_capCNodeRadix(cap);
@@ -38,12 +46,20 @@ lookup_fp(cap_t cap, cptr_t cptr)
            when the guard is 0, when 32MinusGuardSize will be
            reported as 0 also. In this case we skip the check */
         if (likely(guardBits) && unlikely(cptr2 >> (wordBits - guardBits) != capGuard)) {
-            return cap_null_cap_new();
+            return NULL;
         }
 
         radix = cptr2 << guardBits >> (wordBits - radixBits);
         slot = CTE_PTR(cap_cnode_cap_get_capCNodePtr(cap)) + radix;
 
+#ifdef CONFIG_ASYNC_REVOKE
+        /* Leave capabilities queued for an asynchronous revoke to the
+         * slowpath, which refuses them */
+        if (unlikely(mdb_node_get_mdbRevoking(slot->cteMDBNode))) {
+            return NULL;
+        }
+#endif
+
         cap = slot->cap;
         bits += guardBits + radixBits;
 
@@ -52,10 +68,32 @@ lookup_fp(cap_t cap, cptr_t cptr)
     if (unlikely(bits > wordBits)) {
         /* Depth mismatch. We've overshot wordBits bits. The lookup we've done is
            safe, but wouldn't be allowed by the slowpath. */
+        return NULL;
+    }
+
+    return slot;
+}
+
+/* Fastpath cap lookup.  Returns a null_cap on failure. */
+static inline cap_t FORCE_INLINE
+lookup_fp(cte_t *root, cptr_t cptr)
+{
+    cte_t *slot;
+
+    slot = lookup_slot_fp(root, cptr);
+    if (unlikely(!slot)) {
         return cap_null_cap_new();
     }
 
-    return cap;
+    return slot->cap;
+}
+
+/* The fastpath transfers at most one extra cap. Clearing the low bit of the
+ * extraCaps field before the length check lets exactly that case through. */
+static inline word_t FORCE_INLINE
+fastpath_mi_clear_one_cap(word_t msgInfo)
+{
+    return msgInfo & ~BIT(seL4_MsgLengthBits);
 }
 /* make sure the fastpath functions conform with structure_*.bf */
 static inline void
@@ -15,8 +15,10 @@
 
 #ifdef CONFIG_ARCH_X86
 #define MAX_NUM_FREEMEM_REG 16
+#define MAX_NUM_NUMA_REG 16
 #else
 #define MAX_NUM_FREEMEM_REG 2
+#define MAX_NUM_NUMA_REG 1
 #endif
 
 /*
@@ -28,6 +30,12 @@ typedef cte_t* slot_ptr_t;
 #define SLOT_PTR(pptr, pos) (((slot_ptr_t)(pptr)) + (pos))
 #define pptr_of_cap (pptr_t)cap_get_capPtr
 
+/* physical memory with known NUMA locality */
+typedef struct numa_p_region {
+    p_region_t p_reg;
+    word_t     node;
+} numa_p_region_t;
+
 /* (node-local) state accessed only during bootstrapping */
 
 typedef struct ndks_boot {
@@ -35,6 +43,14 @@ typedef struct ndks_boot {
     seL4_BootInfo*      bi_frame;
     seL4_SlotPos slot_pos_cur;
     seL4_SlotPos slot_pos_max;
+    /* filled in by platforms that know their memory locality, untypeds
+     * are split at the boundaries of these regions */
+    numa_p_region_t numa_p_regs[MAX_NUM_NUMA_REG];
+    word_t     num_numa_p_regs;
+    /* extra bootinfo chunk for untyped descriptors beyond untypedList, NULL
+     * if the platform does not provide one */
+    seL4_BootInfo_Untyped *untyped_bi;
+    word_t     untyped_bi_max;
 } ndks_boot_t;
 
 extern ndks_boot_t ndks_boot;
@@ -63,7 +79,10 @@ void create_domain_cap(cap_t root_cnode_cap);
 
 cap_t create_ipcbuf_frame(cap_t root_cnode_cap, cap_t pd_cap, vptr_t vptr);
 
+word_t calculate_extra_bi_size_bits(word_t extra_size);
 region_t allocate_extra_bi_region(word_t extra_size);
+word_t calculate_untyped_bi_size(void);
+void populate_untyped_bi(pptr_t pptr, word_t size);
 pptr_t allocate_bi_frame(node_id_t node_id, word_t num_nodes, vptr_t ipcbuf_vptr);
 
 void create_bi_frame_cap(cap_t root_cnode_cap, cap_t pd_cap, pptr_t pptr, vptr_t vptr);
@@ -75,6 +75,10 @@ void switchToIdleThread(void);
 void setDomain(tcb_t *tptr, dom_t dom);
 void setPriority(tcb_t *tptr, prio_t prio);
 void setMCPriority(tcb_t *tptr, prio_t mcp);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+void inheritPriority(tcb_t *server, tcb_t *client);
+void restorePriority(tcb_t *tptr);
+#endif
 void scheduleTCB(tcb_t *tptr);
 void attemptSwitchTo(tcb_t *tptr);
 void switchIfRequiredTo(tcb_t *tptr);
@@ -82,4 +86,9 @@ void setThreadState(tcb_t *tptr, _thread_state_t ts);
 void timerTick(void);
 void rescheduleRequired(void);
 
+#ifdef CONFIG_KERNEL_TIMEOUTS
+/* End the timed wait of a thread whose deadline has passed */
+void timeoutThread(tcb_t *tptr);
+#endif
+
 #endif
@@ -25,6 +25,16 @@ static inline void c_entry_hook(void)
 #if defined(CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES) || defined(CONFIG_BENCHMARK_TRACK_UTILISATION)
     ksEnter = timestamp();
 #endif
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    benchmark_utilisation_kentry();
+#endif
+#if defined(CONFIG_THREAD_REGISTRY) && defined(CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES)
+    NODE_STATE(ksKernelEntryTag) = NODE_STATE(ksCurThread)->tcbTag;
+#endif
+#ifdef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG
+    NODE_STATE(ksWatchdogEntryThread) = NODE_STATE(ksCurThread);
+    NODE_STATE(ksWatchdogPreemptionPoints) = 0;
+#endif
 }
 
 /* This C function should be the last thing called from C before exiting
@@ -36,6 +46,9 @@ static inline void c_exit_hook(void)
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
     benchmark_track_exit();
 #endif /* CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES */
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    benchmark_utilisation_kexit();
+#endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
     arch_c_exit_hook();
 }
 
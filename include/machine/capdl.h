@@ -11,6 +11,8 @@
 #ifndef __MACHINE_CAPDL_H
 #define __MACHINE_CAPDL_H
 
+#include <config.h>
+
 #define ESCAPE               0xaa
 #define START                0xff
 #define END                  0xbb
@@ -33,4 +35,26 @@
 
 #define CAPDL_VERSION        0
 
+#ifdef CONFIG_DEBUG_BUILD
+
+#include <types.h>
+#include <api/failures.h>
+#include <machine/capdl_types.h>
+
+/* Number of CNodes and TCBs destroyed. A preempted snapshot holds pointers
+ * to CNodes and TCBs, so it is abandoned if this changes */
+extern word_t ksCapDLObjectsDestroyed;
+
+/* Write a binary capDL image of the capability state of the system into
+ * the frames at the numFrames consecutive cptrs starting at frames. The
+ * snapshot is preemptible; a preempted snapshot is continued when the
+ * same thread repeats the call with the same arguments on the same node.
+ * The frames are only written, never read back. */
+exception_t capDL_snapshot(cptr_t frames, word_t numFrames);
+
+/* Size in bytes of the image written by the last snapshot */
+word_t capDL_snapshotSize(void);
+
+#endif /* CONFIG_DEBUG_BUILD */
+
 #endif
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the GNU General Public License version 2. Note that NO WARRANTY is provided.
+ * See "LICENSE_GPLv2.txt" for details.
+ *
+ * @TAG(DATA61_GPL)
+ */
+
+#ifndef __MODEL_KERNEL_STATS_H_
+#define __MODEL_KERNEL_STATS_H_
+
+#include <config.h>
+#include <types.h>
+#include <api/failures.h>
+#include <model/statedata.h>
+#include <model/kernel_stats_types.h>
+
+#ifdef CONFIG_KERNEL_STATS
+
+/* Counters only ever change on their own core, so these are plain
+ * increments of core local memory */
+#define KERNEL_STATS_INC(_counter)     NODE_STATE(ksKernelStats)[(_counter)]++
+#define KERNEL_STATS_ADD(_counter, _n) NODE_STATE(ksKernelStats)[(_counter)] += (_n)
+#define KERNEL_STATS_IRQ(_irq)         NODE_STATE(ksKernelStatsIRQs)[(_irq)]++
+
+/* Count a remote TLB invalidation if it has to interrupt another core */
+#define KERNEL_STATS_SHOOTDOWN(_mask) do {                                  \
+    if ((_mask) & ~BIT(getCurrentCPUIndex())) {                             \
+        KERNEL_STATS_INC(seL4_KernelStats_TLBShootdowns);                   \
+    }                                                                       \
+} while (0)
+
+/* Write the counters of a node into the current thread's message
+ * registers, followed by the IRQ counts from firstIRQ onwards */
+exception_t kernelStats_dump(word_t node, word_t firstIRQ);
+
+#else
+
+#define KERNEL_STATS_INC(_counter)
+#define KERNEL_STATS_ADD(_counter, _n)
+#define KERNEL_STATS_IRQ(_irq)
+#define KERNEL_STATS_SHOOTDOWN(_mask)
+
+#endif /* CONFIG_KERNEL_STATS */
+
+#endif /* __MODEL_KERNEL_STATS_H_ */
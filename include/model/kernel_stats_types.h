@@ -0,0 +1 @@
+../../libsel4/include/sel4/kernel_stats_types.h
\ No newline at end of file
@@ -18,6 +18,9 @@
 #include <object/structures.h>
 #include <object/tcb.h>
 #include <mode/types.h>
+#include <plat/machine.h>
+#include <model/kernel_stats_types.h>
+#include <benchmark/benchmark_track_types.h>
 
 #ifdef ENABLE_SMP_SUPPORT
 #define NODE_STATE_BEGIN(_name)                 typedef struct _name {
@@ -74,12 +77,57 @@ NODE_STATE_DECLARE(word_t, ksFPURestoresSinceSwitch);
 #ifdef CONFIG_DEBUG_BUILD
 NODE_STATE_DECLARE(tcb_t *, ksDebugTCBs);
 #endif /* CONFIG_DEBUG_BUILD */
+#ifdef CONFIG_KERNEL_TIMEOUTS
+/* Threads in a timed wait on this node, earliest deadline first */
+NODE_STATE_DECLARE(tcb_t *, ksSleepQueue);
+#endif /* CONFIG_KERNEL_TIMEOUTS */
+#ifdef CONFIG_KERNEL_STATS
+/* Statistics counters, updated through model/kernel_stats.h */
+NODE_STATE_DECLARE(word_t, ksKernelStats[seL4_KernelStats_IRQs]);
+NODE_STATE_DECLARE(word_t, ksKernelStatsIRQs[maxIRQ + 1]);
+#endif /* CONFIG_KERNEL_STATS */
+#ifdef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG
+/* Ring of entries that exceeded the watchdog threshold, and the total number captured */
+NODE_STATE_DECLARE(benchmark_watchdog_entry_t, ksWatchdogLog[CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG_ENTRIES]);
+NODE_STATE_DECLARE(word_t, ksWatchdogLogIndex);
+NODE_STATE_DECLARE(benchmark_watchdog_entry_t, ksWatchdogMax[BENCHMARK_WATCHDOG_MAX_ENTRIES]);
+/* Thread that made the current kernel entry and preemption points passed so far */
+NODE_STATE_DECLARE(tcb_t *, ksWatchdogEntryThread);
+NODE_STATE_DECLARE(word_t, ksWatchdogPreemptionPoints);
+#endif /* CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG */
+#if defined(CONFIG_THREAD_REGISTRY) && defined(CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES)
+/* Tag of the thread that made the current kernel entry */
+NODE_STATE_DECLARE(uint64_t, ksKernelEntryTag);
+#endif
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+/* Thread that kernel time of the current entry is charged to, what for,
+ * and when the kernel was last exited */
+NODE_STATE_DECLARE(tcb_t *, ksBenchmarkEntryThread);
+NODE_STATE_DECLARE(word_t, ksBenchmarkEntryCause);
+NODE_STATE_DECLARE(timestamp_t, ksBenchmarkExitTime);
+#endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
 
 NODE_STATE_END(nodeState);
 
 extern word_t ksNumCPUs;
 
+#ifdef CONFIG_THREAD_REGISTRY
+extern tcb_t *ksThreadRegistry;
+#endif
+
+#ifdef CONFIG_KERNEL_TIMEOUTS
+extern word_t ksTicks;
+#endif
+
 extern word_t ksWorkUnitsCompleted;
+#ifdef CONFIG_MULTICAST
+extern word_t ksRecvStamp;
+#endif
+#ifdef CONFIG_ASYNC_REVOKE
+extern cte_t ksAsyncRevokeUntyped;
+extern cte_t ksAsyncRevokeNotification;
+extern bool_t ksAsyncRevokeSlice;
+#endif
 extern irq_state_t intStateIRQTable[];
 extern cte_t *intStateIRQNode;
 extern const dschedule_t ksDomSchedule[];
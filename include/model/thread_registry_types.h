@@ -0,0 +1 @@
+../../libsel4/include/sel4/thread_registry_types.h
\ No newline at end of file
@@ -26,6 +26,9 @@ exception_t decodeCNodeInvocation(word_t invLabel, word_t length,
                                   cap_t cap, extra_caps_t excaps,
                                   word_t *buffer);
 exception_t invokeCNodeRevoke(cte_t *destSlot);
+#ifdef CONFIG_ASYNC_REVOKE
+exception_t invokeCNodeRevokeAsync(cte_t *destSlot, cte_t *ntfnSlot);
+#endif
 exception_t invokeCNodeDelete(cte_t *destSlot);
 exception_t invokeCNodeCancelBadgedSends(cap_t cap);
 exception_t invokeCNodeInsert(cap_t cap, cte_t *srcSlot, cte_t *destSlot);
@@ -39,6 +42,10 @@ void capSwapForDelete(cte_t *slot1, cte_t *slot2);
 void cteSwap(cap_t cap1, cte_t *slot1, cap_t cap2, cte_t *slot2);
 exception_t cteRevoke(cte_t *slot);
 exception_t cteDelete(cte_t *slot, bool_t exposed);
+#ifdef CONFIG_ASYNC_REVOKE
+bool_t isAsyncRevokePending(void);
+void drainAsyncRevoke(bool_t idle);
+#endif
 void cteDeleteOne(cte_t* slot);
 void insertNewCap(cte_t *parent, cte_t *slot, cap_t cap);
 void setupReplyMaster(tcb_t *thread);
@@ -17,6 +17,10 @@
 void sendIPC(bool_t blocking, bool_t do_call, word_t badge,
              bool_t canGrant, tcb_t *thread, endpoint_t *epptr);
 void receiveIPC(tcb_t *thread, cap_t cap, bool_t isBlocking);
+#ifdef CONFIG_MULTICAST
+exception_t multicastIPC(word_t badge, word_t limit, tcb_t *thread,
+                         endpoint_t *epptr);
+#endif
 void cancelIPC(tcb_t *tptr);
 void cancelAllIPC(endpoint_t *epptr);
 void cancelBadgedSends(endpoint_t *epptr, word_t badge);
@@ -135,7 +135,7 @@ struct cte {
 };
 typedef struct cte cte_t;
 
-#define nullMDBNode mdb_node_new(0, false, false, 0)
+#define nullMDBNode mdb_node_new(0, false, false, 0, false)
 
 /* Thread state */
 enum _thread_state {
@@ -148,6 +148,9 @@ enum _thread_state {
     ThreadState_BlockedOnNotification,
 #ifdef CONFIG_VTX
     ThreadState_RunningVM,
+#endif
+#ifdef CONFIG_KERNEL_TIMEOUTS
+    ThreadState_BlockedOnTimeout,
 #endif
     ThreadState_IdleThreadState
 };
@@ -235,6 +238,43 @@ struct tcb {
     /* userland virtual address of thread IPC buffer, 4 bytes */
     word_t tcbIPCBuffer;
 
+#ifdef CONFIG_FRAME_DONATION
+    /* userland virtual address and size in pages of the window that
+     * frames donated to this thread are mapped into, 8 bytes */
+    word_t tcbDonationWindow;
+    word_t tcbDonationWindowPages;
+
+    /* Whether frame caps sent by this thread are donated, 4 bytes */
+    bool_t tcbDonateFrames;
+#endif
+
+#ifdef CONFIG_FAULT_PROFILES
+    /* Registers sent in this thread's unknown syscall and user exception
+     * fault messages, as bitmasks over the full message. 0 selects the full
+     * message, 8 bytes */
+    word_t tcbSyscallFaultRegs;
+    word_t tcbExceptionFaultRegs;
+#endif
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    /* Whether this thread runs at the priority of higher priority threads
+     * that call it, whether it currently is, and the priority it returns to
+     * when it replies or blocks to receive, 12 bytes */
+    bool_t tcbInheritPriority;
+    bool_t tcbBoosted;
+    prio_t tcbBasePriority;
+#endif
+
+#ifdef CONFIG_MULTICAST
+    /* Stamp taken when this thread was last queued to receive on an
+     * endpoint, and the endpoint, starting stamp and count delivered of a
+     * multicast by this thread that was preempted, 16 bytes */
+    word_t tcbRecvStamp;
+    endpoint_t *tcbMulticastEP;
+    word_t tcbMulticastStart;
+    word_t tcbMulticastDelivered;
+#endif
+
 #ifdef ENABLE_SMP_SUPPORT
     /* cpu ID this thread is running on */
     word_t tcbAffinity;
@@ -251,6 +291,22 @@ struct tcb {
     benchmark_util_t benchmark;
 #endif
 
+#ifdef CONFIG_KERNEL_TIMEOUTS
+    /* Tick at which a timed wait ends, whether the thread is in its node's
+     * sleep queue and the pointers for that queue, 16 bytes */
+    word_t tcbDeadline;
+    bool_t tcbSleeping;
+    struct tcb *tcbSleepNext;
+    struct tcb *tcbSleepPrev;
+#endif
+
+#ifdef CONFIG_THREAD_REGISTRY
+    /* user assigned tag for profiling and the list of all tcbs, 16 bytes */
+    uint64_t tcbTag;
+    struct tcb *tcbRegistryNext;
+    struct tcb *tcbRegistryPrev;
+#endif
+
 #ifdef CONFIG_DEBUG_BUILD
     /* Pointers for list of all tcbs that is maintained
      * when CONFIG_DEBUG_BUILD is enabled */
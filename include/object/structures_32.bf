@@ -153,7 +153,8 @@ block mdb_node {
     field mdbFirstBadged 1
 
     field_high mdbPrev 29
-    padding 3
+    padding 2
+    field mdbRevoking 1
 }
 
 -- Thread state data
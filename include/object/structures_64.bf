@@ -149,7 +149,10 @@ block mdb_node {
     field mdbRevocable 1
     field mdbFirstBadged 1
 
-    field mdbPrev 64
+    padding 15
+    field_high mdbPrev 47
+    padding 1
+    field mdbRevoking 1
 }
 
 -- Thread state data
@@ -56,6 +56,19 @@ void tcbDebugAppend(tcb_t *tcb);
 void tcbDebugRemove(tcb_t *tcb);
 #endif
 
+#ifdef CONFIG_THREAD_REGISTRY
+void tcbRegistryAppend(tcb_t *tcb);
+void tcbRegistryRemove(tcb_t *tcb);
+/* Write the registry entries from index first onwards into the current
+ * thread's IPC buffer */
+exception_t threadRegistry_dump(word_t first);
+#endif
+
+#ifdef CONFIG_KERNEL_TIMEOUTS
+void tcbSleepEnqueue(tcb_t *tcb, word_t deadline);
+void tcbSleepDequeue(tcb_t *tcb);
+#endif
+
 #ifdef ENABLE_SMP_SUPPORT
 void remoteQueueUpdate(tcb_t *tcb);
 void remoteTCBStall(tcb_t *tcb);
@@ -94,6 +107,8 @@ exception_t decodeCopyRegisters(cap_t cap, word_t length,
 exception_t decodeReadRegisters(cap_t cap, word_t length, bool_t call,
                                 word_t *buffer);
 exception_t decodeWriteRegisters(cap_t cap, word_t length, word_t *buffer);
+exception_t decodeCNodeRegisters(word_t invLabel, word_t length, cap_t cap,
+                                 extra_caps_t excaps, word_t *buffer);
 exception_t decodeTCBConfigure(cap_t cap, word_t length,
                                cte_t* slot, extra_caps_t rootCaps, word_t *buffer);
 exception_t decodeSetPriority(cap_t cap, word_t length, word_t *buffer);
@@ -106,6 +121,18 @@ exception_t decodeDomainInvocation(word_t invLabel, word_t length,
                                    extra_caps_t excaps, word_t *buffer);
 exception_t decodeBindNotification(cap_t cap, extra_caps_t excaps);
 exception_t decodeUnbindNotification(cap_t cap);
+#ifdef CONFIG_FRAME_DONATION
+exception_t decodeSetDonationWindow(cap_t cap, word_t length, word_t *buffer);
+#endif
+#ifdef CONFIG_FAULT_PROFILES
+exception_t decodeSetFaultProfile(cap_t cap, word_t length, word_t *buffer);
+#endif
+#ifdef CONFIG_PRIORITY_INHERITANCE
+exception_t decodeSetPriorityInheritance(cap_t cap, word_t length, word_t *buffer);
+#endif
+#ifdef CONFIG_THREAD_REGISTRY
+exception_t decodeSetTag(cap_t cap, word_t length, word_t *buffer);
+#endif
 
 enum thread_control_flag {
     thread_control_update_priority = 0x1,
@@ -134,6 +161,20 @@ exception_t invokeTCB_ReadRegisters(tcb_t *src, bool_t suspendSource,
 exception_t invokeTCB_WriteRegisters(tcb_t *dest, bool_t resumeTarget,
                                      word_t n, word_t arch, word_t *buffer);
 exception_t invokeTCB_NotificationControl(tcb_t *tcb, notification_t *ntfnPtr);
+#ifdef CONFIG_FRAME_DONATION
+exception_t invokeTCB_SetDonationWindow(tcb_t *tcb, word_t window,
+                                        word_t windowPages, bool_t donate);
+#endif
+#ifdef CONFIG_FAULT_PROFILES
+exception_t invokeTCB_SetFaultProfile(tcb_t *tcb, word_t syscallRegs,
+                                      word_t exceptionRegs);
+#endif
+#ifdef CONFIG_PRIORITY_INHERITANCE
+exception_t invokeTCB_SetPriorityInheritance(tcb_t *tcb, bool_t inherit);
+#endif
+#ifdef CONFIG_THREAD_REGISTRY
+exception_t invokeTCB_SetTag(tcb_t *tcb, uint64_t tag);
+#endif
 
 cptr_t PURE getExtraCPtr(word_t *bufferPtr, word_t i);
 void setExtraBadge(word_t *bufferPtr, word_t badge, word_t i);
@@ -14,6 +14,8 @@
 #include <assert.h>
 #include <config.h>
 #include <types.h>
+#include <api/bootinfo_types.h>
+#include <arch/api/bootinfo_types.h>
 
 /* Generic System Descriptor Table Header */
 typedef struct acpi_header {
@@ -66,4 +68,40 @@ bool_t acpi_fadt_scan(
     acpi_rsdt_t* acpi_rsdt
 );
 
+/* maximum number of memory affinity ranges we record while SRAT parsing */
+#define MAX_NUM_NUMA_MEM_REGIONS 16
+/* maximum number of processor affinity entries we record while SRAT parsing */
+#define MAX_NUM_NUMA_CPUS 256
+
+typedef struct acpi_numa_mem {
+    p_region_t p_reg;
+    uint32_t   node;
+} acpi_numa_mem_t;
+
+typedef struct acpi_numa_cpu {
+    cpu_id_t apic_id;
+    uint32_t node;
+} acpi_numa_cpu_t;
+
+typedef struct acpi_numa_info {
+    /* number of proximity domains, 0 if there is no usable SRAT */
+    uint32_t        num_nodes;
+    uint32_t        num_mem;
+    acpi_numa_mem_t mem[MAX_NUM_NUMA_MEM_REGIONS];
+    uint32_t        num_cpus;
+    acpi_numa_cpu_t cpus[MAX_NUM_NUMA_CPUS];
+    /* relative distances from the SLIT, all 0 if there is none */
+    uint8_t         distance[SEL4_X86_MAX_NUMA_NODES][SEL4_X86_MAX_NUMA_NODES];
+} acpi_numa_info_t;
+
+void acpi_srat_scan(
+    acpi_rsdt_t* acpi_rsdt,
+    acpi_numa_info_t* numa_info
+);
+
+uint32_t acpi_numa_cpu_node(
+    acpi_numa_info_t* numa_info,
+    cpu_id_t apic_id
+);
+
 #endif
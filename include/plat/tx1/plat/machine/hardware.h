@@ -56,8 +56,8 @@ static const p_region_t BOOT_RODATA avail_p_regs[] = {
 };
 
 static const p_region_t BOOT_RODATA dev_p_regs[] = {
-    { UARTA_SYNC_PADDR,     UARTA_SYNC_PADDR + (BIT(seL4_PageBits) * 3 ) },    /* 12 KB, multiple */
-    { TMR_PADDR,            TMR_PADDR + BIT(seL4_PageBits) }                   /* 4 Kb            */
+    { UARTA_SYNC_PADDR,     UARTA_SYNC_PADDR + (BIT(DEVICE_FRAME_BITS) * 3 ) },    /* 12 KB, multiple */
+    { TMR_PADDR,            TMR_PADDR + BIT(DEVICE_FRAME_BITS) }                   /* 4 Kb            */
 };
 
 /* Handle a platform-reserved IRQ. */
@@ -17,6 +17,7 @@
 #include <sel4/arch/functions.h>
 #include <sel4/sel4_arch/syscalls.h>
 #include <sel4/types.h>
+#include <sel4/bootinfo_types.h>
 
 LIBSEL4_INLINE_FUNC void
 seL4_Send(seL4_CPtr dest, seL4_MessageInfo_t msgInfo)
@@ -54,6 +55,30 @@ seL4_NBSendWithMRs(seL4_CPtr dest, seL4_MessageInfo_t msgInfo,
                 );
 }
 
+#ifdef CONFIG_MULTICAST
+LIBSEL4_INLINE_FUNC seL4_Word
+seL4_Multicast(seL4_CPtr dest, seL4_MessageInfo_t msgInfo, seL4_Word limit)
+{
+    seL4_MessageInfo_t info;
+    seL4_Word msg0;
+    seL4_Word msg1;
+    seL4_Word msg2;
+    seL4_Word msg3;
+
+    /* The limit is passed in the message register after the message */
+    if (seL4_MessageInfo_get_length(msgInfo) < seL4_MsgMaxLength) {
+        seL4_SetMR(seL4_MessageInfo_get_length(msgInfo), limit);
+    }
+    msg0 = seL4_GetMR(0);
+    msg1 = seL4_GetMR(1);
+    msg2 = seL4_GetMR(2);
+    msg3 = seL4_GetMR(3);
+    arm_sys_send_recv(seL4_SysMulticast, dest, &dest, msgInfo.words[0], &info.words[0], &msg0, &msg1, &msg2, &msg3);
+
+    return dest;
+}
+#endif /* CONFIG_MULTICAST */
+
 LIBSEL4_INLINE_FUNC void
 seL4_Reply(seL4_MessageInfo_t msgInfo)
 {
@@ -352,6 +377,21 @@ seL4_DebugSnapshot(void)
     asm volatile("" ::: "memory");
 }
 
+LIBSEL4_INLINE_FUNC seL4_Error
+seL4_DebugSnapshotBuffer(seL4_CPtr frames, seL4_Word num_frames, seL4_Word *size)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+    seL4_Word unused3 = 0;
+
+    arm_sys_send_recv(seL4_SysDebugSnapshotBuffer, frames, &frames, num_frames, &num_frames, &unused0, &unused1, &unused2, &unused3);
+    if (size) {
+        *size = num_frames;
+    }
+    return (seL4_Error)frames;
+}
+
 LIBSEL4_INLINE_FUNC seL4_Uint32
 seL4_DebugCapIdentify(seL4_CPtr cap)
 {
@@ -477,8 +517,124 @@ seL4_BenchmarkResetThreadUtilisation(seL4_Word tcb_cptr)
     arm_sys_send_recv(seL4_SysBenchmarkResetThreadUtilisation, tcb_cptr, &unused0, 0, &unused1, &unused2, &unused3, &unused4, &unused5);
 }
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
+
+#ifdef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG
+/*
+ * Clear the kernel entries captured by the watchdog on all cores. A non zero
+ * threshold replaces the current latency threshold.
+ */
+LIBSEL4_INLINE_FUNC void
+seL4_BenchmarkWatchdogReset(seL4_Word threshold)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+    seL4_Word unused3 = 0;
+    seL4_Word unused4 = 0;
+    seL4_Word unused5 = 0;
+
+    arm_sys_send_recv(seL4_SysBenchmarkWatchdogReset, threshold, &unused0, 0, &unused1, &unused2, &unused3, &unused4, &unused5);
+}
+
+/*
+ * Copy entries of a watchdog table (see benchmark_watchdog_table) of a node
+ * into the IPC buffer as benchmark_watchdog_entry_t, starting at entry first.
+ * num_entries is set to the number of entries copied.
+ */
+LIBSEL4_INLINE_FUNC seL4_Error
+seL4_BenchmarkWatchdogDump(seL4_Word node, seL4_Word table, seL4_Word first, seL4_Word *num_entries)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+
+    arm_sys_send_recv(seL4_SysBenchmarkWatchdogDump, node, &node, table, &table, &first, &unused0, &unused1, &unused2);
+    if (num_entries) {
+        *num_entries = table;
+    }
+    return (seL4_Error)node;
+}
+#endif /* CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG */
 #endif /* CONFIG_ENABLE_BENCHMARKS */
 
+#ifdef CONFIG_KERNEL_STATS
+/*
+ * Read the statistics counters of a node into the IPC buffer, indexed by
+ * seL4_KernelStatsIndex, followed by the counts of IRQs starting at
+ * first_irq. num_irqs is set to the number of IRQ counts returned.
+ */
+LIBSEL4_INLINE_FUNC seL4_Error
+seL4_KernelStats(seL4_Word node, seL4_Word first_irq, seL4_Word *num_irqs)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+    seL4_Word unused3 = 0;
+
+    arm_sys_send_recv(seL4_SysKernelStats, node, &node, first_irq, &first_irq, &unused0, &unused1, &unused2, &unused3);
+    if (num_irqs) {
+        *num_irqs = first_irq;
+    }
+    return (seL4_Error)node;
+}
+#endif /* CONFIG_KERNEL_STATS */
+
+#ifdef CONFIG_THREAD_REGISTRY
+/*
+ * Read the thread registry into the IPC buffer as seL4_ThreadRegistryEntry_t
+ * entries, starting from entry first. num_entries is set to the number of
+ * entries returned, which is 0 once the end of the registry is reached.
+ */
+LIBSEL4_INLINE_FUNC seL4_Error
+seL4_ThreadRegistryDump(seL4_Word first, seL4_Word *num_entries)
+{
+    seL4_Word count = 0;
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+    seL4_Word unused3 = 0;
+
+    arm_sys_send_recv(seL4_SysThreadRegistryDump, first, &first, count, &count, &unused0, &unused1, &unused2, &unused3);
+    if (num_entries) {
+        *num_entries = count;
+    }
+    return (seL4_Error)first;
+}
+#endif /* CONFIG_THREAD_REGISTRY */
+
+#ifdef CONFIG_KERNEL_TIMEOUTS
+/*
+ * Receive on src, giving up once the timeout, in timer ticks, has passed.
+ * flags is a combination of seL4_TimeoutFlags. A receive that timed out
+ * returns a message of length seL4_TimeoutMsgLength, see seL4_TimedOut, and
+ * sets sender to the current tick. With seL4_TimeoutSleep no cap is used
+ * and the call always ends this way.
+ */
+LIBSEL4_INLINE_FUNC seL4_MessageInfo_t
+seL4_RecvTimeout(seL4_CPtr src, seL4_Word timeout, seL4_Word flags, seL4_Word *sender)
+{
+    seL4_MessageInfo_t info;
+    seL4_Word badge;
+    seL4_Word msg0 = flags;
+    seL4_Word msg1 = 0;
+    seL4_Word msg2 = 0;
+    seL4_Word msg3 = 0;
+
+    arm_sys_send_recv(seL4_SysRecvTimeout, src, &badge, timeout, &info.words[0], &msg0, &msg1, &msg2, &msg3);
+
+    seL4_SetMR(0, msg0);
+    seL4_SetMR(1, msg1);
+    seL4_SetMR(2, msg2);
+    seL4_SetMR(3, msg3);
+
+    if (sender) {
+        *sender = badge;
+    }
+
+    return info;
+}
+#endif /* CONFIG_KERNEL_TIMEOUTS */
+
 LIBSEL4_INLINE_FUNC void
 seL4_Wait(seL4_CPtr src, seL4_Word *sender)
 {
@@ -491,4 +647,38 @@ seL4_Poll(seL4_CPtr src, seL4_Word *sender)
     return seL4_NBRecv(src, sender);
 }
 
+#ifdef CONFIG_KERNEL_TIMEOUTS
+LIBSEL4_INLINE_FUNC seL4_Bool
+seL4_TimedOut(seL4_MessageInfo_t info)
+{
+    return seL4_MessageInfo_get_length(info) == seL4_TimeoutMsgLength;
+}
+
+LIBSEL4_INLINE_FUNC seL4_MessageInfo_t
+seL4_WaitTimeout(seL4_CPtr src, seL4_Word timeout, seL4_Word flags, seL4_Word *sender)
+{
+    return seL4_RecvTimeout(src, timeout, flags, sender);
+}
+
+/* Sleep for the given number of ticks and return the current tick */
+LIBSEL4_INLINE_FUNC seL4_Word
+seL4_Sleep(seL4_Word ticks)
+{
+    seL4_Word now;
+
+    seL4_RecvTimeout(seL4_CapNull, ticks, seL4_TimeoutSleep, &now);
+    return now;
+}
+
+/* Sleep until the given tick and return the current tick */
+LIBSEL4_INLINE_FUNC seL4_Word
+seL4_SleepUntil(seL4_Word deadline)
+{
+    seL4_Word now;
+
+    seL4_RecvTimeout(seL4_CapNull, deadline, seL4_TimeoutSleep | seL4_TimeoutAbsolute, &now);
+    return now;
+}
+#endif /* CONFIG_KERNEL_TIMEOUTS */
+
 #endif
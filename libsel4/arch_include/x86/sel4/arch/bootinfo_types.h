@@ -15,6 +15,10 @@
 
 #define SEL4_MULTIBOOT_MAX_MMAP_ENTRIES 50
 #define SEL4_MULTIBOOT_RAM_REGION_TYPE 1
+#define SEL4_X86_MAX_NUMA_NODES 8
+#define SEL4_X86_MAX_NUMA_CPUS 256
+#define SEL4_X86_MAX_BOOT_MODULES 16
+#define SEL4_X86_BOOT_MODULE_CMDLINE_LEN 64
 
 typedef struct seL4_VBEInfoBlock {
     char        signature[4];
@@ -127,4 +131,39 @@ typedef struct seL4_X86_BootInfo_mmap {
     seL4_X86_mb_mmap_t mmap[SEL4_MULTIBOOT_MAX_MMAP_ENTRIES];
 } SEL4_PACKED seL4_X86_BootInfo_mmap_t;
 
+/**
+ * NUMA topology from the ACPI SRAT and SLIT. Node numbers are ACPI proximity
+ * domains and match the numaNode of untyped descriptors. If the firmware
+ * provides no SRAT then numNodes is 0 and everything is on node 0.
+ */
+typedef struct seL4_X86_BootInfo_NUMA {
+    seL4_BootInfoHeader header;
+    seL4_Uint32 numNodes;
+    /* NUMA node of each seL4 node, indexed by CPU index. Only the entries
+     * of CPUs that were booted are valid */
+    seL4_Uint8  cpuNode[SEL4_X86_MAX_NUMA_CPUS];
+    /* relative memory latency from node i to node j, 10 is local. All 0 if
+     * the firmware provides no SLIT */
+    seL4_Uint8  distance[SEL4_X86_MAX_NUMA_NODES][SEL4_X86_MAX_NUMA_NODES];
+} SEL4_PACKED seL4_X86_BootInfo_NUMA;
+
+/**
+ * Multiboot modules after the first one (which is the root task) are left in
+ * place. Their memory is not part of any untyped, instead frames are the caps
+ * to its pages in order: a large page wherever a whole large page lies within
+ * the module, small pages otherwise.
+ */
+typedef struct seL4_X86_BootModule {
+    uint64_t paddr; // physical address of the start of the module
+    uint64_t size; // size of the module in bytes
+    seL4_SlotRegion frames; // frame caps covering the module
+    char cmdline[SEL4_X86_BOOT_MODULE_CMDLINE_LEN]; // module command line, NUL terminated
+} SEL4_PACKED seL4_X86_BootModule_t;
+
+typedef struct seL4_X86_BootInfo_Modules {
+    seL4_BootInfoHeader header;
+    seL4_Uint32 numModules;
+    seL4_X86_BootModule_t modules[SEL4_X86_MAX_BOOT_MODULES];
+} SEL4_PACKED seL4_X86_BootInfo_Modules;
+
 #endif // __LIBSEL4_ARCH_BOOTINFO_TYPES_H
@@ -17,6 +17,7 @@
 #include <sel4/arch/functions.h>
 #include <sel4/sel4_arch/syscalls.h>
 #include <sel4/types.h>
+#include <sel4/bootinfo_types.h>
 
 LIBSEL4_INLINE_FUNC void
 seL4_Wait(seL4_CPtr src, seL4_Word *sender)
@@ -30,4 +31,38 @@ seL4_Poll(seL4_CPtr src, seL4_Word *sender)
     return seL4_NBRecv(src, sender);
 }
 
+#ifdef CONFIG_KERNEL_TIMEOUTS
+LIBSEL4_INLINE_FUNC seL4_Bool
+seL4_TimedOut(seL4_MessageInfo_t info)
+{
+    return seL4_MessageInfo_get_length(info) == seL4_TimeoutMsgLength;
+}
+
+LIBSEL4_INLINE_FUNC seL4_MessageInfo_t
+seL4_WaitTimeout(seL4_CPtr src, seL4_Word timeout, seL4_Word flags, seL4_Word *sender)
+{
+    return seL4_RecvTimeout(src, timeout, flags, sender);
+}
+
+/* Sleep for the given number of ticks and return the current tick */
+LIBSEL4_INLINE_FUNC seL4_Word
+seL4_Sleep(seL4_Word ticks)
+{
+    seL4_Word now;
+
+    seL4_RecvTimeout(seL4_CapNull, ticks, seL4_TimeoutSleep, &now);
+    return now;
+}
+
+/* Sleep until the given tick and return the current tick */
+LIBSEL4_INLINE_FUNC seL4_Word
+seL4_SleepUntil(seL4_Word deadline)
+{
+    seL4_Word now;
+
+    seL4_RecvTimeout(seL4_CapNull, deadline, seL4_TimeoutSleep | seL4_TimeoutAbsolute, &now);
+    return now;
+}
+#endif /* CONFIG_KERNEL_TIMEOUTS */
+
 #endif
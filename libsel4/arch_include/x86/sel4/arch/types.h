@@ -42,6 +42,13 @@ typedef enum {
     SEL4_FORCE_LONG_ENUM(seL4_X86_VMAttributes),
 } seL4_X86_VMAttributes;
 
+/* Bits selected by the flags of HarvestStatusBits */
+typedef enum {
+    seL4_X86_StatusAccessed = 0x1,
+    seL4_X86_StatusDirty = 0x2,
+    SEL4_FORCE_LONG_ENUM(seL4_X86_StatusBits),
+} seL4_X86_StatusBits;
+
 typedef struct seL4_VCPUContext_ {
     seL4_Word eax, ebx, ecx, edx, esi, edi, ebp;
 } seL4_VCPUContext;
@@ -21,6 +21,10 @@
 typedef struct benchmark_tracepoint_log_entry {
     seL4_Word  id;
     seL4_Word  duration;
+#ifdef CONFIG_THREAD_REGISTRY
+    /* tag of the thread that was current when the trace point stopped */
+    uint64_t   thread_tag;
+#endif
 } benchmark_tracepoint_log_entry_t;
 #endif /* CONFIG_BENCHMARK_TRACEPOINTS */
 
@@ -66,8 +66,52 @@ typedef struct benchmark_syscall_log_entry {
     uint64_t  start_time;
     uint32_t  duration;
     kernel_entry_t entry;
+#ifdef CONFIG_THREAD_REGISTRY
+    /* tag of the thread that made the entry */
+    uint64_t  thread_tag;
+#endif
 } benchmark_track_kernel_entry_t;
 
 #endif /* CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES || CONFIG_DEBUG_BUILD */
 
+#ifdef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG
+
+/* Tables that can be read with seL4_BenchmarkWatchdogDump */
+enum benchmark_watchdog_table {
+    /* Most recent entries that exceeded the threshold, oldest first */
+    BENCHMARK_WATCHDOG_LOG,
+    /* Longest entry seen for each entry type, see below for the layout */
+    BENCHMARK_WATCHDOG_MAX
+};
+
+/* The BENCHMARK_WATCHDOG_MAX table holds one entry per kernel entry path,
+ * followed by one per syscall number, followed by one per type of the
+ * invoked cap. A syscall updates both its syscall and its cap type entry. */
+#define BENCHMARK_WATCHDOG_NUM_PATHS     8
+#define BENCHMARK_WATCHDOG_NUM_SYSCALLS  16
+#define BENCHMARK_WATCHDOG_NUM_CAP_TYPES 32
+#define BENCHMARK_WATCHDOG_MAX_SYSCALL   BENCHMARK_WATCHDOG_NUM_PATHS
+#define BENCHMARK_WATCHDOG_MAX_CAP_TYPE  (BENCHMARK_WATCHDOG_MAX_SYSCALL + BENCHMARK_WATCHDOG_NUM_SYSCALLS)
+#define BENCHMARK_WATCHDOG_MAX_ENTRIES   (BENCHMARK_WATCHDOG_MAX_CAP_TYPE + BENCHMARK_WATCHDOG_NUM_CAP_TYPES)
+
+typedef struct benchmark_watchdog_entry {
+    uint64_t  start_time;
+    uint32_t  duration;
+    kernel_entry_t entry;
+    /* core the entry happened on */
+    seL4_Word core;
+    /* number of preemption points passed during the entry */
+    seL4_Word preemption_points;
+    /* kernel addresses of the thread that entered the kernel and of
+     * the thread the kernel exited to */
+    seL4_Word cur_thread;
+    seL4_Word next_thread;
+#ifdef CONFIG_THREAD_REGISTRY
+    /* tag of the thread that entered the kernel */
+    uint64_t  thread_tag;
+#endif
+} benchmark_watchdog_entry_t;
+
+#endif /* CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG */
+
 #endif /* BENCHMARK_TRACK_TYPES_H */
@@ -21,8 +21,32 @@
 enum benchmark_track_util_ipc_index {
     BENCHMARK_TCB_UTILISATION,
     BENCHMARK_IDLE_UTILISATION,
-    BENCHMARK_TOTAL_UTILISATION
+    BENCHMARK_TOTAL_UTILISATION,
+    /* Time the requested thread spent at user level */
+    BENCHMARK_TCB_USER_TIME,
+    /* Kernel time spent on behalf of the requested thread, one entry for
+     * each benchmark_kernel_time_index */
+    BENCHMARK_TCB_KERNEL_TIME
 };
 
+/* Causes that kernel time is attributed to. Kernel time is charged to the
+ * thread that was current when the kernel was entered */
+enum benchmark_kernel_time_index {
+    /* Syscalls handled by the slowpath, including unknown syscalls */
+    BENCHMARK_KERNEL_TIME_SLOWPATH,
+    /* Syscalls handled by the fastpath */
+    BENCHMARK_KERNEL_TIME_FASTPATH,
+    /* Interrupts and IPIs that arrived while the thread was current */
+    BENCHMARK_KERNEL_TIME_INTERRUPT,
+    /* Faults, debug exceptions and VM exits */
+    BENCHMARK_KERNEL_TIME_FAULT,
+    BENCHMARK_KERNEL_TIME_NUM_CAUSES
+};
+
+#ifdef CONFIG_THREAD_REGISTRY
+/* Tag of the requested thread, after its kernel time entries */
+#define BENCHMARK_TCB_TAG (BENCHMARK_TCB_KERNEL_TIME + BENCHMARK_KERNEL_TIME_NUM_CAUSES)
+#endif
+
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
 #endif /* BENCHMARK_TRACK_UTIL_TYPES_H */
@@ -45,7 +45,7 @@ typedef struct {
 
 typedef struct {
     seL4_Word  paddr;   /* physical address of untyped cap  */
-    seL4_Uint8 padding1;
+    seL4_Uint8 numaNode;/* NUMA node of the memory (0 if unknown) */
     seL4_Uint8 padding2;
     seL4_Uint8 sizeBits;/* size (2^n) bytes of each untyped */
     seL4_Uint8 isDevice;/* whether the untyped is a device  */
@@ -68,8 +68,10 @@ typedef struct {
     seL4_Word         archInfo;        /* tsc freq on x86, unused on arm */
     seL4_SlotRegion   untyped;         /* untyped-object caps (untyped caps) */
     seL4_UntypedDesc  untypedList[CONFIG_MAX_NUM_BOOTINFO_UNTYPED_CAPS]; /* information about each untyped */
-    /* the untypedList should be the last entry in this struct, in order
-     * to make this struct easier to represent in other languages */
+    /* new fields go after untypedList, so that the offsets of existing
+     * fields do not change. The size of the structure still changes with
+     * every field added, and untypedList is no longer the last entry */
+    seL4_Word         untypedDropped;  /* number of untyped regions that could not be provided */
 } SEL4_PACKED seL4_BootInfo;
 
 /* If extraLen > 0 then 4K after the start of bootinfo is a region of extraLen additional
@@ -87,5 +89,16 @@ typedef struct {
 #define SEL4_BOOTINFO_HEADER_PADDING 0
 #define SEL4_BOOTINFO_HEADER_X86_VBE 1
 #define SEL4_BOOTINFO_HEADER_X86_MBMMAP 2
+#define SEL4_BOOTINFO_HEADER_X86_NUMA 3
+#define SEL4_BOOTINFO_HEADER_UNTYPED 4
+#define SEL4_BOOTINFO_HEADER_X86_MODULES 5
+
+/* Descriptors of the untyped caps that did not fit into untypedList. The chunk
+ * is followed by numUntypeds seL4_UntypedDesc, the n-th of which describes the
+ * cap in slot untyped.start + CONFIG_MAX_NUM_BOOTINFO_UNTYPED_CAPS + n */
+typedef struct {
+    seL4_BootInfoHeader header;
+    seL4_Word numUntypeds;
+} SEL4_PACKED seL4_BootInfo_Untyped;
 
 #endif // __LIBSEL4_BOOTINFO_TYPES_H
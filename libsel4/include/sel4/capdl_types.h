@@ -0,0 +1,57 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+
+#ifndef CAPDL_TYPES_H
+#define CAPDL_TYPES_H
+
+#ifdef HAVE_AUTOCONF
+#include <autoconf.h>
+#endif
+
+#ifdef CONFIG_DEBUG_BUILD
+
+#define seL4_CapDLSnapshotMagic    0x5e14cd1
+#define seL4_CapDLSnapshotVersion  1
+
+/* Types of the records in a binary capDL snapshot image */
+typedef enum {
+    /* Always record 0. object: kernel sizeof(cte_t), index: number of
+     * records in the image, data[0]: magic, data[1]: version,
+     * data[2]: number of nodes */
+    seL4_CapDLSnapshot_Header,
+    /* object: TCB pointer, index: node the TCB was listed on,
+     * data[0]: thread state, data[1]: priority, data[2]: bound notification,
+     * data[3]: address of the TCB's CNode slots */
+    seL4_CapDLSnapshot_TCB,
+    /* object: address of the first slot, index: number of slots */
+    seL4_CapDLSnapshot_CNode,
+    /* object: address of the containing CNode, index: slot number,
+     * data[0..1]: cap words, data[2..3]: MDB node words */
+    seL4_CapDLSnapshot_Slot,
+    /* object: node, index: position in the node's scheduler queues
+     * (0 is the current thread), data[0]: TCB pointer */
+    seL4_CapDLSnapshot_RunQueue,
+    seL4_CapDLSnapshot_NumTypes
+} seL4_CapDLSnapshotType;
+
+/* Every record is a power of two in size, so records never straddle the
+ * frames that make up the image */
+typedef struct seL4_CapDLSnapshotRecord {
+    seL4_Word type;
+    seL4_Word object;
+    seL4_Word index;
+    seL4_Word data[5];
+} seL4_CapDLSnapshotRecord_t;
+
+#endif /* CONFIG_DEBUG_BUILD */
+
+#endif /* CAPDL_TYPES_H */
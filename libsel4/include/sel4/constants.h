@@ -67,6 +67,22 @@ enum {
 };
 #define seL4_MsgMaxExtraCaps (LIBSEL4_BIT(seL4_MsgExtraCapBits)-1)
 
+#ifdef CONFIG_KERNEL_TIMEOUTS
+/* Flags for seL4_RecvTimeout. Timeouts are relative to the current tick
+ * unless seL4_TimeoutAbsolute is given. */
+typedef enum {
+    seL4_TimeoutAbsolute = LIBSEL4_BIT(0),
+    seL4_TimeoutSleep = LIBSEL4_BIT(1),
+    SEL4_FORCE_LONG_ENUM(seL4_TimeoutFlags),
+} seL4_TimeoutFlags;
+
+/* Message length reported by a receive that timed out. No sender can
+ * produce it. */
+enum {
+    seL4_TimeoutMsgLength = seL4_MsgMaxLength + 1,
+};
+#endif /* CONFIG_KERNEL_TIMEOUTS */
+
 typedef enum {
     seL4_NoFailure = 0,
     seL4_InvalidRoot,
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+
+#ifndef KERNEL_STATS_TYPES_H
+#define KERNEL_STATS_TYPES_H
+
+#ifdef HAVE_AUTOCONF
+#include <autoconf.h>
+#endif
+
+#ifdef CONFIG_KERNEL_STATS
+
+/* Message registers filled in by seL4_KernelStats. All counters are per
+ * core and count from boot. */
+enum seL4_KernelStatsIndex {
+    /* Kernel entries, by type. Syscalls include fastpath hits. */
+    seL4_KernelStats_Syscalls,
+    seL4_KernelStats_Interrupts,
+    seL4_KernelStats_UnknownSyscalls,
+    seL4_KernelStats_UserLevelFaults,
+    seL4_KernelStats_VMFaults,
+    seL4_KernelStats_DebugFaults,
+    seL4_KernelStats_VMExits,
+    /* Calls and ReplyRecvs that completed on the fastpath */
+    seL4_KernelStats_FastpathCalls,
+    seL4_KernelStats_FastpathReplyRecvs,
+    /* Switches to a different thread, including to the idle thread */
+    seL4_KernelStats_ContextSwitches,
+    /* IPIs sent to, and received from, other cores */
+    seL4_KernelStats_IPIsSent,
+    seL4_KernelStats_IPIsReceived,
+    /* Remote TLB invalidations that had to interrupt other cores */
+    seL4_KernelStats_TLBShootdowns,
+    /* Long running operations interrupted at a preemption point */
+    seL4_KernelStats_Preemptions,
+    /* Per IRQ counts, starting at the requested IRQ, fill the remaining
+     * message registers */
+    seL4_KernelStats_IRQs
+};
+
+#endif /* CONFIG_KERNEL_STATS */
+
+#endif /* KERNEL_STATS_TYPES_H */
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+
+#ifndef REGISTER_SNAPSHOT_TYPES_H
+#define REGISTER_SNAPSHOT_TYPES_H
+
+#define seL4_RegisterSnapshotMagic    0x5e14e65
+#define seL4_RegisterSnapshotVersion  1
+
+/* Header at the start of a frame written by seL4_CNode_SaveRegisters. It is
+ * followed by numRecords records of recordSize bytes each. A record is the
+ * CNode index of the TCB cap, then numRegisters words of registers in
+ * seL4_UserContext order, then fpuSize bytes of FPU state in the format used
+ * by the hardware (FXSAVE/XSAVE area on x86), padded to a word */
+typedef struct seL4_RegisterSnapshotHeader {
+    seL4_Word magic;
+    seL4_Word version;
+    seL4_Word numRecords;
+    seL4_Word recordSize;
+    seL4_Word numRegisters;
+    seL4_Word fpuSize;
+    /* first slot of the window that was not saved because the frame was
+     * full, or the end of the window */
+    seL4_Word nextSlot;
+} seL4_RegisterSnapshotHeader_t;
+
+#endif /* REGISTER_SNAPSHOT_TYPES_H */
@@ -107,6 +107,28 @@ seL4_Reply(seL4_MessageInfo_t msgInfo);
 LIBSEL4_INLINE_FUNC void
 seL4_NBSend(seL4_CPtr dest, seL4_MessageInfo_t msgInfo);
 
+#ifdef CONFIG_MULTICAST
+/**
+ * @xmlonly <manual name="Multicast" label="sel4_multicast"/> @endxmlonly
+ * @brief Send a message to every thread waiting on an endpoint
+ *
+ * @xmlonly
+ * See <autoref label="sec:sys_multicast"/>
+ * @endxmlonly
+ *
+ * @param[in] dest The endpoint capability to be invoked.
+ * @param[in] msgInfo The messageinfo structure for the IPC.
+ * @param[in] limit The maximum number of threads to deliver to, or 0 for
+ *                  no limit. It is passed in the message register after
+ *                  the message, so a message of seL4_MsgMaxLength words
+ *                  is always delivered without a limit.
+ *
+ * @return The number of threads the message was delivered to.
+ */
+LIBSEL4_INLINE_FUNC seL4_Word
+seL4_Multicast(seL4_CPtr dest, seL4_MessageInfo_t msgInfo, seL4_Word limit);
+#endif
+
 /**
  * @xmlonly <manual name="Reply Recv" label="sel4_replyrecv"/> @endxmlonly
  * @brief Perform a reply followed by a receive in one system call
@@ -452,7 +474,9 @@ seL4_BenchmarkFlushCaches(void);
  *
  * Get timing information for the system, requested thread and idle thread. Such information is written
  * into the caller's IPC buffer; see the definition of `benchmark_track_util_ipc_index` enum for more
- * details on the data/format returned on the IPC buffer.
+ * details on the data/format returned on the IPC buffer. The requested thread's time is also split into
+ * user time and kernel time by cause (`benchmark_kernel_time_index`), where kernel time is charged to
+ * the thread that was running when the kernel was entered.
  *
  * @param[in] tcb_cptr TCB cap pointer to a thread to get CPU utilisation for.
  */
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the BSD 2-Clause license. Note that NO WARRANTY is provided.
+ * See "LICENSE_BSD2.txt" for details.
+ *
+ * @TAG(DATA61_BSD)
+ */
+
+#ifndef THREAD_REGISTRY_TYPES_H
+#define THREAD_REGISTRY_TYPES_H
+
+#ifdef HAVE_AUTOCONF
+#include <autoconf.h>
+#endif
+
+#ifdef CONFIG_THREAD_REGISTRY
+
+/* Entries written into the IPC buffer by seL4_ThreadRegistryDump, one per
+ * thread in the registry. With CONFIG_BENCHMARK_TRACK_UTILISATION,
+ * benchmark_utilisation_types.h must be included first */
+typedef struct seL4_ThreadRegistryEntry {
+    /* tag set with seL4_TCB_SetTag, 0 if none was set */
+    uint64_t tag;
+    /* kernel address of the TCB, as reported by the watchdog */
+    uint64_t thread;
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    /* as returned by seL4_BenchmarkGetThreadUtilisation */
+    uint64_t utilisation;
+    uint64_t user_time;
+    uint64_t kernel_time[BENCHMARK_KERNEL_TIME_NUM_CAUSES];
+#endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
+} seL4_ThreadRegistryEntry_t;
+
+#endif /* CONFIG_THREAD_REGISTRY */
+
+#endif /* THREAD_REGISTRY_TYPES_H */
@@ -65,14 +65,31 @@ enum {
 #define seL4_DataFault 0
 #define seL4_InstructionFault 1
 /* object sizes - 2^n */
+#ifdef CONFIG_ARM_USER_64K_GRANULE
+#define seL4_PageBits 16
+#define seL4_LargePageBits 29
+/* The span of a first level entry. Blocks of this size cannot be mapped
+ * with the 64K granule and 48-bit physical addresses. */
+#define seL4_HugePageBits 42
+#else
 #define seL4_PageBits 12
 #define seL4_LargePageBits 21
 #define seL4_HugePageBits 30
+#endif
 #define seL4_SlotBits 5
 #define seL4_TCBBits 11
 #define seL4_EndpointBits 4
 #define seL4_NotificationBits 5
 
+#ifdef CONFIG_ARM_USER_64K_GRANULE
+#define seL4_PageTableBits 16
+#define seL4_PageTableEntryBits 3
+#define seL4_PageTableIndexBits 13
+
+#define seL4_PageDirBits 16
+#define seL4_PageDirEntryBits 3
+#define seL4_PageDirIndexBits 13
+#else
 #define seL4_PageTableBits 12
 #define seL4_PageTableEntryBits 3
 #define seL4_PageTableIndexBits 9
@@ -80,12 +97,24 @@ enum {
 #define seL4_PageDirBits 12
 #define seL4_PageDirEntryBits 3
 #define seL4_PageDirIndexBits 9
+#endif
 
 #define seL4_ASIDPoolBits 12
 #define seL4_ASIDPoolIndexBits 9
 #define seL4_IOPageTableBits 12
 #define seL4_WordSizeBits 3
 
+#ifdef CONFIG_ARM_USER_64K_GRANULE
+/* Three levels: the PGD entries point straight at page directories and
+ * there is no PUD level, which is described as a PUD of a single entry */
+#define seL4_PGDBits 9
+#define seL4_PGDEntryBits 3
+#define seL4_PGDIndexBits    6
+
+#define seL4_PUDBits 3
+#define seL4_PUDEntryBits 3
+#define seL4_PUDIndexBits 0
+#else
 #define seL4_PGDBits 12
 #define seL4_PGDEntryBits 3
 #define seL4_PGDIndexBits    9
@@ -93,6 +122,7 @@ enum {
 #define seL4_PUDBits 12
 #define seL4_PUDEntryBits 3
 #define seL4_PUDIndexBits 9
+#endif
 
 /* word size */
 #define seL4_WordBits (sizeof(seL4_Word) * 8)
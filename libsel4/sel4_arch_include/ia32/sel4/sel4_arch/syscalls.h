@@ -318,6 +318,26 @@ seL4_NBSendWithMRs(seL4_CPtr dest, seL4_MessageInfo_t msgInfo,
     x86_sys_send(seL4_SysNBSend, dest, msgInfo.words[0], mr0 != seL4_Null ? *mr0 : 0, mr1 != seL4_Null ? *mr1 : 0);
 }
 
+#ifdef CONFIG_MULTICAST
+LIBSEL4_INLINE_FUNC seL4_Word
+seL4_Multicast(seL4_CPtr dest, seL4_MessageInfo_t msgInfo, seL4_Word limit)
+{
+    seL4_MessageInfo_t info;
+    seL4_Word mr0;
+    seL4_Word mr1;
+
+    /* The limit is passed in the message register after the message */
+    if (seL4_MessageInfo_get_length(msgInfo) < seL4_MsgMaxLength) {
+        seL4_SetMR(seL4_MessageInfo_get_length(msgInfo), limit);
+    }
+    mr0 = seL4_GetMR(0);
+    mr1 = seL4_GetMR(1);
+    x86_sys_send_recv(seL4_SysMulticast, dest, &dest, msgInfo.words[0], &info.words[0], &mr0, &mr1);
+
+    return dest;
+}
+#endif /* CONFIG_MULTICAST */
+
 LIBSEL4_INLINE_FUNC void
 seL4_Reply(seL4_MessageInfo_t msgInfo)
 {
@@ -563,6 +583,19 @@ seL4_DebugSnapshot(void)
     x86_sys_null(seL4_SysDebugSnapshot);
     asm volatile("" :::"%esi", "%edi", "memory");
 }
+
+LIBSEL4_INLINE_FUNC seL4_Error
+seL4_DebugSnapshotBuffer(seL4_CPtr frames, seL4_Word num_frames, seL4_Word *size)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+
+    x86_sys_send_recv(seL4_SysDebugSnapshotBuffer, frames, &frames, num_frames, &num_frames, &unused0, &unused1);
+    if (size) {
+        *size = num_frames;
+    }
+    return (seL4_Error)frames;
+}
 #endif
 
 #ifdef CONFIG_DEBUG_BUILD
@@ -678,6 +711,110 @@ seL4_BenchmarkResetThreadUtilisation(seL4_Word tcb_cptr)
     x86_sys_send_recv(seL4_SysBenchmarkResetThreadUtilisation, tcb_cptr, &unused0, 0, &unused1, &unused2, &unused3);
 }
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
+
+#ifdef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG
+/*
+ * Clear the kernel entries captured by the watchdog on all cores. A non zero
+ * threshold replaces the current latency threshold.
+ */
+LIBSEL4_INLINE_FUNC void
+seL4_BenchmarkWatchdogReset(seL4_Word threshold)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+    seL4_Word unused3 = 0;
+
+    x86_sys_send_recv(seL4_SysBenchmarkWatchdogReset, threshold, &unused0, 0, &unused1, &unused2, &unused3);
+}
+
+/*
+ * Copy entries of a watchdog table (see benchmark_watchdog_table) of a node
+ * into the IPC buffer as benchmark_watchdog_entry_t, starting at entry first.
+ * num_entries is set to the number of entries copied.
+ */
+LIBSEL4_INLINE_FUNC seL4_Error
+seL4_BenchmarkWatchdogDump(seL4_Word node, seL4_Word table, seL4_Word first, seL4_Word *num_entries)
+{
+    seL4_Word unused0 = 0;
+
+    x86_sys_send_recv(seL4_SysBenchmarkWatchdogDump, node, &node, table, &table, &first, &unused0);
+    if (num_entries) {
+        *num_entries = table;
+    }
+    return (seL4_Error)node;
+}
+#endif /* CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG */
 #endif /* CONFIG_ENABLE_BENCHMARKS */
 
+#ifdef CONFIG_KERNEL_STATS
+/*
+ * Read the statistics counters of a node into the IPC buffer, indexed by
+ * seL4_KernelStatsIndex, followed by the counts of IRQs starting at
+ * first_irq. num_irqs is set to the number of IRQ counts returned.
+ */
+LIBSEL4_INLINE_FUNC seL4_Error
+seL4_KernelStats(seL4_Word node, seL4_Word first_irq, seL4_Word *num_irqs)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+
+    x86_sys_send_recv(seL4_SysKernelStats, node, &node, first_irq, &first_irq, &unused0, &unused1);
+    if (num_irqs) {
+        *num_irqs = first_irq;
+    }
+    return (seL4_Error)node;
+}
+#endif /* CONFIG_KERNEL_STATS */
+
+#ifdef CONFIG_THREAD_REGISTRY
+/*
+ * Read the thread registry into the IPC buffer as seL4_ThreadRegistryEntry_t
+ * entries, starting from entry first. num_entries is set to the number of
+ * entries returned, which is 0 once the end of the registry is reached.
+ */
+LIBSEL4_INLINE_FUNC seL4_Error
+seL4_ThreadRegistryDump(seL4_Word first, seL4_Word *num_entries)
+{
+    seL4_Word count = 0;
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+
+    x86_sys_send_recv(seL4_SysThreadRegistryDump, first, &first, count, &count, &unused0, &unused1);
+    if (num_entries) {
+        *num_entries = count;
+    }
+    return (seL4_Error)first;
+}
+#endif /* CONFIG_THREAD_REGISTRY */
+
+#ifdef CONFIG_KERNEL_TIMEOUTS
+/*
+ * Receive on src, giving up once the timeout, in timer ticks, has passed.
+ * flags is a combination of seL4_TimeoutFlags. A receive that timed out
+ * returns a message of length seL4_TimeoutMsgLength, see seL4_TimedOut, and
+ * sets sender to the current tick. With seL4_TimeoutSleep no cap is used
+ * and the call always ends this way.
+ */
+LIBSEL4_INLINE_FUNC seL4_MessageInfo_t
+seL4_RecvTimeout(seL4_CPtr src, seL4_Word timeout, seL4_Word flags, seL4_Word *sender)
+{
+    seL4_MessageInfo_t info;
+    seL4_Word badge;
+    seL4_Word mr0 = flags;
+    seL4_Word mr1 = 0;
+
+    x86_sys_send_recv(seL4_SysRecvTimeout, src, &badge, timeout, &info.words[0], &mr0, &mr1);
+
+    seL4_SetMR(0, mr0);
+    seL4_SetMR(1, mr1);
+
+    if (sender) {
+        *sender = badge;
+    }
+
+    return info;
+}
+#endif /* CONFIG_KERNEL_TIMEOUTS */
+
 #endif
@@ -73,6 +73,74 @@ setMRs_lookup_failure(tcb_t *receiver, word_t* receiveIPCBuffer,
     }
 }
 
+#ifdef CONFIG_FAULT_PROFILES
+/* Registers of a fault message that are sent to the handler of the thread,
+ * as a bitmask over the indices of the full message */
+static inline word_t
+faultMessageRegs(tcb_t *tcb, MessageID_t id)
+{
+    word_t regs;
+
+    if (id == MessageID_Syscall) {
+        regs = tcb->tcbSyscallFaultRegs;
+        return regs ? regs : MASK(n_syscallMessage);
+    } else {
+        regs = tcb->tcbExceptionFaultRegs;
+        return regs ? regs : MASK(n_exceptionMessage);
+    }
+}
+
+static inline void
+copyMRsFaultReply(tcb_t *sender, tcb_t *receiver, MessageID_t id, word_t regs, word_t length)
+{
+    word_t i, n;
+    word_t *sendBuf = NULL;
+    bool_t archInfo;
+
+    archInfo = Arch_getSanitiseRegisterInfo(receiver);
+
+    /* Message register n is written back to the n-th register selected by
+     * the receiver's fault profile */
+    for (i = 0, n = 0; regs != 0 && n < length; i++, regs >>= 1) {
+        register_t r;
+        word_t v;
+
+        if (!(regs & 1)) {
+            continue;
+        }
+        r = fault_messages[id][i];
+        if (n < n_msgRegisters) {
+            v = getRegister(sender, msgRegisters[n]);
+        } else {
+            if (n == n_msgRegisters) {
+                sendBuf = lookupIPCBuffer(false, sender);
+            }
+            if (!sendBuf) {
+                return;
+            }
+            v = sendBuf[n + 1];
+        }
+        setRegister(receiver, r, sanitiseRegister(r, v, archInfo));
+        n++;
+    }
+}
+
+/* Returns the number of message registers used */
+static inline word_t
+copyMRsFault(tcb_t *sender, tcb_t *receiver, MessageID_t id,
+             word_t regs, word_t *receiveIPCBuffer)
+{
+    word_t i, n;
+
+    for (i = 0, n = 0; regs != 0; i++, regs >>= 1) {
+        if (regs & 1) {
+            setMR(receiver, receiveIPCBuffer, n, getRegister(sender, fault_messages[id][i]));
+            n++;
+        }
+    }
+    return n;
+}
+#else
 static inline void
 copyMRsFaultReply(tcb_t *sender, tcb_t *receiver, MessageID_t id, word_t length)
 {
@@ -114,6 +182,7 @@ copyMRsFault(tcb_t *sender, tcb_t *receiver, MessageID_t id,
         }
     }
 }
+#endif /* CONFIG_FAULT_PROFILES */
 
 bool_t
 handleFaultReply(tcb_t *receiver, tcb_t *sender)
@@ -129,11 +198,21 @@ handleFaultReply(tcb_t *receiver, tcb_t *sender)
         return true;
 
     case seL4_Fault_UnknownSyscall:
+#ifdef CONFIG_FAULT_PROFILES
+        copyMRsFaultReply(sender, receiver, MessageID_Syscall,
+                          faultMessageRegs(receiver, MessageID_Syscall), length);
+#else
         copyMRsFaultReply(sender, receiver, MessageID_Syscall, MIN(length, n_syscallMessage));
+#endif
         return (label == 0);
 
     case seL4_Fault_UserException:
+#ifdef CONFIG_FAULT_PROFILES
+        copyMRsFaultReply(sender, receiver, MessageID_Exception,
+                          faultMessageRegs(receiver, MessageID_Exception), length);
+#else
         copyMRsFaultReply(sender, receiver, MessageID_Exception, MIN(length, n_exceptionMessage));
+#endif
         return (label == 0);
 
 #ifdef CONFIG_HARDWARE_DEBUG_API
@@ -202,19 +281,35 @@ setMRs_fault(tcb_t *sender, tcb_t* receiver, word_t *receiveIPCBuffer)
                                      sender->tcbLookupFailure, seL4_CapFault_LookupFailureType);
 
     case seL4_Fault_UnknownSyscall: {
+        word_t n;
+
+#ifdef CONFIG_FAULT_PROFILES
+        n = copyMRsFault(sender, receiver, MessageID_Syscall,
+                         faultMessageRegs(sender, MessageID_Syscall), receiveIPCBuffer);
+#else
         copyMRsFault(sender, receiver, MessageID_Syscall, n_syscallMessage,
                      receiveIPCBuffer);
+        n = n_syscallMessage;
+#endif
 
-        return setMR(receiver, receiveIPCBuffer, n_syscallMessage,
+        return setMR(receiver, receiveIPCBuffer, n,
                      seL4_Fault_UnknownSyscall_get_syscallNumber(sender->tcbFault));
     }
 
     case seL4_Fault_UserException: {
+        word_t n;
+
+#ifdef CONFIG_FAULT_PROFILES
+        n = copyMRsFault(sender, receiver, MessageID_Exception,
+                         faultMessageRegs(sender, MessageID_Exception), receiveIPCBuffer);
+#else
         copyMRsFault(sender, receiver, MessageID_Exception,
                      n_exceptionMessage, receiveIPCBuffer);
-        setMR(receiver, receiveIPCBuffer, n_exceptionMessage,
+        n = n_exceptionMessage;
+#endif
+        setMR(receiver, receiveIPCBuffer, n,
               seL4_Fault_UserException_get_number(sender->tcbFault));
-        return setMR(receiver, receiveIPCBuffer, n_exceptionMessage + 1u,
+        return setMR(receiver, receiveIPCBuffer, n + 1u,
                      seL4_Fault_UserException_get_code(sender->tcbFault));
     }
 
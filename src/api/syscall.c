@@ -24,14 +24,23 @@
 #include <plat/machine/hardware.h>
 #include <object/interrupt.h>
 #include <model/statedata.h>
+#include <model/kernel_stats.h>
 #include <string.h>
 #include <kernel/traps.h>
 #include <arch/machine.h>
 
 #ifdef CONFIG_DEBUG_BUILD
+#include <machine/capdl.h>
 #include <arch/machine/capdl.h>
 #endif
 
+#ifdef CONFIG_KERNEL_TIMEOUTS
+static void handleRecvTimeout(void);
+#endif
+#ifdef CONFIG_MULTICAST
+static exception_t handleMulticast(void);
+#endif
+
 /* The haskell function 'handleEvent' is split into 'handleXXX' variants
  * for each event causing a kernel entry */
 
@@ -40,6 +49,11 @@ handleInterruptEntry(void)
 {
     irq_t irq;
 
+    KERNEL_STATS_INC(seL4_KernelStats_Interrupts);
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    benchmark_utilisation_kentry_cause(BENCHMARK_KERNEL_TIME_INTERRUPT);
+#endif
+
     irq = getActiveIRQ();
 
     if (irq != irqInvalid) {
@@ -61,6 +75,11 @@ handleInterruptEntry(void)
 exception_t
 handleUnknownSyscall(word_t w)
 {
+    KERNEL_STATS_INC(seL4_KernelStats_UnknownSyscalls);
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    benchmark_utilisation_kentry_cause(BENCHMARK_KERNEL_TIME_SLOWPATH);
+#endif
+
 #ifdef CONFIG_PRINTING
     if (w == SysDebugPutChar) {
         kernel_putchar(getRegister(NODE_STATE(ksCurThread), capRegister));
@@ -83,6 +102,33 @@ handleUnknownSyscall(word_t w)
         capDL();
         return EXCEPTION_NONE;
     }
+    if (w == SysDebugSnapshotBuffer) {
+        word_t frames = getRegister(NODE_STATE(ksCurThread), capRegister);
+        word_t numFrames = getRegister(NODE_STATE(ksCurThread), msgInfoRegister);
+        exception_t status = capDL_snapshot(frames, numFrames);
+
+        if (status == EXCEPTION_PREEMPTED) {
+            /* rerun the syscall to continue the snapshot once the
+             * interrupt has been handled */
+            irq_t irq = getActiveIRQ();
+            setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+            if (irq != irqInvalid) {
+                handleInterrupt(irq);
+                Arch_finaliseInterrupt();
+            }
+            schedule();
+            activateThread();
+            return EXCEPTION_NONE;
+        }
+
+        if (status == EXCEPTION_SYSCALL_ERROR) {
+            setRegister(NODE_STATE(ksCurThread), capRegister, current_syscall_error.type);
+        } else {
+            setRegister(NODE_STATE(ksCurThread), capRegister, seL4_NoError);
+        }
+        setRegister(NODE_STATE(ksCurThread), msgInfoRegister, capDL_snapshotSize());
+        return EXCEPTION_NONE;
+    }
     if (w == SysDebugCapIdentify) {
         word_t cptr = getRegister(NODE_STATE(ksCurThread), capRegister);
         lookupCapAndSlot_ret_t lu_ret = lookupCapAndSlot(NODE_STATE(ksCurThread), cptr);
@@ -121,6 +167,76 @@ handleUnknownSyscall(word_t w)
     }
 #endif /* CONFIG_DEBUG_BUILD */
 
+#ifdef CONFIG_KERNEL_STATS
+    if (w == SysKernelStats) {
+        word_t node = getRegister(NODE_STATE(ksCurThread), capRegister);
+        word_t firstIRQ = getRegister(NODE_STATE(ksCurThread), msgInfoRegister);
+
+        if (kernelStats_dump(node, firstIRQ) != EXCEPTION_NONE) {
+            setRegister(NODE_STATE(ksCurThread), capRegister, current_syscall_error.type);
+            setRegister(NODE_STATE(ksCurThread), msgInfoRegister, 0);
+        } else {
+            setRegister(NODE_STATE(ksCurThread), capRegister, seL4_NoError);
+        }
+        return EXCEPTION_NONE;
+    }
+#endif /* CONFIG_KERNEL_STATS */
+
+#ifdef CONFIG_THREAD_REGISTRY
+    if (w == SysThreadRegistryDump) {
+        word_t first = getRegister(NODE_STATE(ksCurThread), capRegister);
+        exception_t status = threadRegistry_dump(first);
+
+        if (status == EXCEPTION_PREEMPTED) {
+            /* rerun the syscall, which continues from where the walk to
+             * the first entry was preempted */
+            irq_t irq = getActiveIRQ();
+            setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+            if (irq != irqInvalid) {
+                handleInterrupt(irq);
+                Arch_finaliseInterrupt();
+            }
+            schedule();
+            activateThread();
+            return EXCEPTION_NONE;
+        }
+
+        if (status != EXCEPTION_NONE) {
+            setRegister(NODE_STATE(ksCurThread), capRegister, current_syscall_error.type);
+            setRegister(NODE_STATE(ksCurThread), msgInfoRegister, 0);
+        } else {
+            setRegister(NODE_STATE(ksCurThread), capRegister, seL4_NoError);
+        }
+        return EXCEPTION_NONE;
+    }
+#endif /* CONFIG_THREAD_REGISTRY */
+
+#ifdef CONFIG_KERNEL_TIMEOUTS
+    if (w == SysRecvTimeout) {
+        handleRecvTimeout();
+        schedule();
+        activateThread();
+        return EXCEPTION_NONE;
+    }
+#endif /* CONFIG_KERNEL_TIMEOUTS */
+
+#ifdef CONFIG_MULTICAST
+    if (w == SysMulticast) {
+        if (handleMulticast() == EXCEPTION_PREEMPTED) {
+            /* the thread was left to restart the multicast, which carries on
+             * from the receiver it was preempted at */
+            irq_t irq = getActiveIRQ();
+            if (irq != irqInvalid) {
+                handleInterrupt(irq);
+                Arch_finaliseInterrupt();
+            }
+        }
+        schedule();
+        activateThread();
+        return EXCEPTION_NONE;
+    }
+#endif /* CONFIG_MULTICAST */
+
 #ifdef DANGEROUS_CODE_INJECTION
     if (w == SysDebugRun) {
         ((void (*) (void *))getRegister(NODE_STATE(ksCurThread), capRegister))((void*)getRegister(NODE_STATE(ksCurThread), msgInfoRegister));
@@ -185,6 +301,25 @@ handleUnknownSyscall(word_t w)
     }
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
 
+#ifdef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG
+    else if (w == SysBenchmarkWatchdogReset) {
+        benchmark_watchdog_reset(getRegister(NODE_STATE(ksCurThread), capRegister));
+        return EXCEPTION_NONE;
+    } else if (w == SysBenchmarkWatchdogDump) {
+        word_t node = getRegister(NODE_STATE(ksCurThread), capRegister);
+        word_t table = getRegister(NODE_STATE(ksCurThread), msgInfoRegister);
+        word_t first = getRegister(NODE_STATE(ksCurThread), msgRegisters[0]);
+
+        if (benchmark_watchdog_dump(node, table, first) != EXCEPTION_NONE) {
+            setRegister(NODE_STATE(ksCurThread), capRegister, current_syscall_error.type);
+            setRegister(NODE_STATE(ksCurThread), msgInfoRegister, 0);
+        } else {
+            setRegister(NODE_STATE(ksCurThread), capRegister, seL4_NoError);
+        }
+        return EXCEPTION_NONE;
+    }
+#endif /* CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG */
+
     else if (w == SysBenchmarkNullSyscall) {
         return EXCEPTION_NONE;
     }
@@ -202,6 +337,8 @@ handleUnknownSyscall(word_t w)
 exception_t
 handleUserLevelFault(word_t w_a, word_t w_b)
 {
+    KERNEL_STATS_INC(seL4_KernelStats_UserLevelFaults);
+
     current_fault = seL4_Fault_UserException_new(w_a, w_b);
     handleFault(NODE_STATE(ksCurThread));
 
@@ -216,6 +353,8 @@ handleVMFaultEvent(vm_fault_type_t vm_faultType)
 {
     exception_t status;
 
+    KERNEL_STATS_INC(seL4_KernelStats_VMFaults);
+
     status = handleVMFault(NODE_STATE(ksCurThread), vm_faultType);
     if (status != EXCEPTION_NONE) {
         handleFault(NODE_STATE(ksCurThread));
@@ -391,6 +530,93 @@ handleRecv(bool_t isBlocking)
     }
 }
 
+#ifdef CONFIG_KERNEL_TIMEOUTS
+static void
+handleRecvTimeout(void)
+{
+    tcb_t *thread = NODE_STATE(ksCurThread);
+    word_t timeout = getRegister(thread, msgInfoRegister);
+    word_t flags = getRegister(thread, msgRegisters[0]);
+    word_t deadline;
+
+    if (flags & seL4_TimeoutAbsolute) {
+        deadline = timeout;
+    } else {
+        deadline = ksTicks + timeout;
+    }
+
+    if (flags & seL4_TimeoutSleep) {
+        setThreadState(thread, ThreadState_BlockedOnTimeout);
+    } else {
+        handleRecv(true);
+
+        /* Nothing to time out if a message was waiting or the receive
+         * faulted */
+        switch (thread_state_get_tsType(thread->tcbState)) {
+        case ThreadState_BlockedOnReceive:
+        case ThreadState_BlockedOnNotification:
+            break;
+        default:
+            return;
+        }
+    }
+
+    if ((sword_t)(deadline - ksTicks) <= 0) {
+        timeoutThread(thread);
+    } else {
+        tcbSleepEnqueue(thread, deadline);
+    }
+}
+#endif /* CONFIG_KERNEL_TIMEOUTS */
+
+#ifdef CONFIG_MULTICAST
+static exception_t
+handleMulticast(void)
+{
+    tcb_t *thread;
+    cptr_t cptr;
+    lookupCap_ret_t lu_ret;
+    seL4_MessageInfo_t info;
+    word_t *buffer;
+    word_t length;
+    word_t limit;
+
+    thread = NODE_STATE(ksCurThread);
+    cptr = getRegister(thread, capRegister);
+
+    lu_ret = lookupCap(thread, cptr);
+    if (unlikely(lu_ret.status != EXCEPTION_NONE)) {
+        userError("Multicast to invalid cap #%lu.", cptr);
+        current_fault = seL4_Fault_CapFault_new(cptr, false);
+        handleFault(thread);
+        return EXCEPTION_NONE;
+    }
+
+    if (unlikely(cap_get_capType(lu_ret.cap) != cap_endpoint_cap ||
+                 !cap_endpoint_cap_get_capCanSend(lu_ret.cap))) {
+        userError("Multicast to cap #%lu that is not a sendable endpoint.", cptr);
+        current_lookup_fault = lookup_fault_missing_capability_new(0);
+        current_fault = seL4_Fault_CapFault_new(cptr, false);
+        handleFault(thread);
+        return EXCEPTION_NONE;
+    }
+
+    /* The limit is passed in the message register after the message. A
+     * message of the maximum length has no room for it and is unlimited */
+    info = messageInfoFromWord(getRegister(thread, msgInfoRegister));
+    length = seL4_MessageInfo_get_length(info);
+    buffer = lookupIPCBuffer(false, thread);
+    if (length < seL4_MsgMaxLength && (length < n_msgRegisters || buffer)) {
+        limit = getSyscallArg(length, buffer);
+    } else {
+        limit = 0;
+    }
+
+    return multicastIPC(cap_endpoint_cap_get_capEPBadge(lu_ret.cap), limit, thread,
+                        EP_PTR(cap_endpoint_cap_get_capEPPtr(lu_ret.cap)));
+}
+#endif /* CONFIG_MULTICAST */
+
 static void
 handleYield(void)
 {
@@ -405,6 +631,11 @@ handleSyscall(syscall_t syscall)
     exception_t ret;
     irq_t irq;
 
+    KERNEL_STATS_INC(seL4_KernelStats_Syscalls);
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    benchmark_utilisation_kentry_cause(BENCHMARK_KERNEL_TIME_SLOWPATH);
+#endif
+
     switch (syscall) {
     case SysSend:
         ret = handleInvocation(false, true);
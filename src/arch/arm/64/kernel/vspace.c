@@ -140,27 +140,29 @@ map_kernel_frame(paddr_t paddr, pptr_t vaddr, vm_rights_t vm_rights, vm_attribut
     assert(vaddr >= PPTR_TOP);
 
     if (vm_attributes_get_armPageCacheable(attributes)) {
-        armKSGlobalKernelPT[GET_PT_INDEX(vaddr)] = pte_new(
-                                                       1,                          /* unprivileged execute never */
-                                                       paddr,
-                                                       0,                          /* global */
-                                                       1,                          /* access flag */
-                                                       SMP_TERNARY(3, 0),          /* Inner-shareable if SMP enabled, otherwise unshared */
-                                                       APFromVMRights(vm_rights),
-                                                       NORMAL,
-                                                       0b11                        /* reserved */
-                                                   );
+        armKSGlobalKernelPT[GET_KERNEL_PT_INDEX(vaddr)] = pte_new(
+                                                              1,                          /* unprivileged execute never */
+                                                              0,                          /* contiguous */
+                                                              paddr,
+                                                              0,                          /* global */
+                                                              1,                          /* access flag */
+                                                              SMP_TERNARY(3, 0),          /* Inner-shareable if SMP enabled, otherwise unshared */
+                                                              APFromVMRights(vm_rights),
+                                                              NORMAL,
+                                                              0b11                        /* reserved */
+                                                          );
     } else {
-        armKSGlobalKernelPT[GET_PT_INDEX(vaddr)] = pte_new(
-                                                       1,                          /* unprivileged execute never */
-                                                       paddr,
-                                                       0,                          /* global */
-                                                       1,                          /* access flag */
-                                                       0,                          /* Ignored - Outter shareable */
-                                                       APFromVMRights(vm_rights),
-                                                       DEVICE_nGnRnE,
-                                                       0b11                        /* reserved */
-                                                   );
+        armKSGlobalKernelPT[GET_KERNEL_PT_INDEX(vaddr)] = pte_new(
+                                                              1,                          /* unprivileged execute never */
+                                                              0,                          /* contiguous */
+                                                              paddr,
+                                                              0,                          /* global */
+                                                              1,                          /* access flag */
+                                                              0,                          /* Ignored - Outter shareable */
+                                                              APFromVMRights(vm_rights),
+                                                              DEVICE_nGnRnE,
+                                                              0b11                        /* reserved */
+                                                          );
     }
 }
 
@@ -173,20 +175,20 @@ map_kernel_window(void)
     word_t idx;
 
     /* verify that the kernel window as at the last entry of the PGD */
-    assert(GET_PGD_INDEX(kernelBase) == BIT(PGD_INDEX_BITS) - 1);
-    assert(IS_ALIGNED(kernelBase, seL4_LargePageBits));
+    assert(GET_KERNEL_PGD_INDEX(kernelBase) == BIT(KERNEL_TABLE_INDEX_BITS) - 1);
+    assert(IS_ALIGNED(kernelBase, KERNEL_LARGE_PAGE_BITS));
     /* verify that the kernel device window is 1gb aligned and 1gb in size */
-    assert(GET_PUD_INDEX(PPTR_TOP) == BIT(PUD_INDEX_BITS) - 1);
-    assert(IS_ALIGNED(PPTR_TOP, seL4_HugePageBits));
+    assert(GET_KERNEL_PUD_INDEX(PPTR_TOP) == BIT(KERNEL_TABLE_INDEX_BITS) - 1);
+    assert(IS_ALIGNED(PPTR_TOP, KERNEL_HUGE_PAGE_BITS));
 
     /* place the PUD into the PGD */
-    armKSGlobalKernelPGD[GET_PGD_INDEX(kernelBase)] = pgde_new(
-                                                          pptr_to_paddr(armKSGlobalKernelPUD),
-                                                          0b11  /* reserved */
-                                                      );
+    armKSGlobalKernelPGD[GET_KERNEL_PGD_INDEX(kernelBase)] = pgde_new(
+                                                                 pptr_to_paddr(armKSGlobalKernelPUD),
+                                                                 0b11  /* reserved */
+                                                             );
 
     /* place all PDs except the last one in PUD */
-    for (idx = GET_PUD_INDEX(kernelBase); idx < GET_PUD_INDEX(PPTR_TOP); idx++) {
+    for (idx = GET_KERNEL_PUD_INDEX(kernelBase); idx < GET_KERNEL_PUD_INDEX(PPTR_TOP); idx++) {
         armKSGlobalKernelPUD[idx] = pude_pude_pd_new(
                                         pptr_to_paddr(&armKSGlobalKernelPDs[idx][0])
                                     );
@@ -194,32 +196,46 @@ map_kernel_window(void)
 
     /* map the kernel window using large pages */
     vaddr = kernelBase;
-    for (paddr = physBase; paddr < PADDR_TOP; paddr += BIT(seL4_LargePageBits)) {
-        armKSGlobalKernelPDs[GET_PUD_INDEX(vaddr)][GET_PD_INDEX(vaddr)] = pde_pde_large_new(
-                                                                              1,                        /* unprivileged execute never */
-                                                                              paddr,
-                                                                              0,                        /* global */
-                                                                              1,                        /* access flag */
-                                                                              SMP_TERNARY(3, 0),        /* Inner-shareable if SMP enabled, otherwise unshared */
-                                                                              0,                        /* VMKernelOnly */
-                                                                              NORMAL
-                                                                          );
-        vaddr += BIT(seL4_LargePageBits);
+    for (paddr = physBase; paddr < PADDR_TOP; paddr += BIT(KERNEL_LARGE_PAGE_BITS)) {
+        armKSGlobalKernelPDs[GET_KERNEL_PUD_INDEX(vaddr)][GET_KERNEL_PD_INDEX(vaddr)] = pde_pde_large_new(
+                                                                                            1,                        /* unprivileged execute never */
+                                                                                            paddr,
+                                                                                            0,                        /* global */
+                                                                                            1,                        /* access flag */
+                                                                                            SMP_TERNARY(3, 0),        /* Inner-shareable if SMP enabled, otherwise unshared */
+                                                                                            0,                        /* VMKernelOnly */
+                                                                                            NORMAL
+                                                                                        );
+        vaddr += BIT(KERNEL_LARGE_PAGE_BITS);
     }
 
     /* put the PD into the PUD for device window */
-    armKSGlobalKernelPUD[GET_PUD_INDEX(PPTR_TOP)] = pude_pude_pd_new(
-                                                        pptr_to_paddr(&armKSGlobalKernelPDs[BIT(PUD_INDEX_BITS) - 1][0])
-                                                    );
+    armKSGlobalKernelPUD[GET_KERNEL_PUD_INDEX(PPTR_TOP)] = pude_pude_pd_new(
+                                                               pptr_to_paddr(&armKSGlobalKernelPDs[BIT(KERNEL_TABLE_INDEX_BITS) - 1][0])
+                                                           );
 
     /* put the PT into the PD for device window */
-    armKSGlobalKernelPDs[BIT(PUD_INDEX_BITS) - 1][BIT(PD_INDEX_BITS) - 1] = pde_pde_small_new(
-                                                                                pptr_to_paddr(armKSGlobalKernelPT)
-                                                                            );
+    armKSGlobalKernelPDs[BIT(KERNEL_TABLE_INDEX_BITS) - 1][BIT(KERNEL_TABLE_INDEX_BITS) - 1] = pde_pde_small_new(
+                                                                                                   pptr_to_paddr(armKSGlobalKernelPT)
+                                                                                               );
 
     map_kernel_devices();
 }
 
+/* With the 64K granule user address spaces have no PUD level. The PGD
+ * entries point straight at page directories and are used as PUD entries,
+ * which have the same layout. */
+static inline pude_t *
+pgdeToPUDSlot(pgde_t *pgdSlot, vptr_t vptr)
+{
+#ifdef CONFIG_ARM_USER_64K_GRANULE
+    return (pude_t *)pgdSlot;
+#else
+    pude_t *pud = paddr_to_pptr(pgde_ptr_get_pud_base_address(pgdSlot));
+    return pud + GET_PUD_INDEX(vptr);
+#endif
+}
+
 static BOOT_CODE void
 map_it_frame_cap(cap_t vspace_cap, cap_t frame_cap, bool_t executable)
 {
@@ -235,8 +251,7 @@ map_it_frame_cap(cap_t vspace_cap, cap_t frame_cap, bool_t executable)
 
     pgd += GET_PGD_INDEX(vptr);
     assert(pgde_ptr_get_present(pgd));
-    pud = paddr_to_pptr(pgde_ptr_get_pud_base_address(pgd));
-    pud += GET_PUD_INDEX(vptr);
+    pud = pgdeToPUDSlot(pgd, vptr);
     assert(pude_pude_pd_ptr_get_present(pud));
     pd = paddr_to_pptr(pude_pude_pd_ptr_get_pd_base_address(pud));
     pd += GET_PD_INDEX(vptr);
@@ -244,6 +259,7 @@ map_it_frame_cap(cap_t vspace_cap, cap_t frame_cap, bool_t executable)
     pt = paddr_to_pptr(pde_pde_small_ptr_get_pt_base_address(pd));
     *(pt + GET_PT_INDEX(vptr)) = pte_new(
                                      !executable,                    /* unprivileged execute never */
+                                     0,                              /* contiguous */
                                      pptr_to_paddr(pptr),            /* page_base_address    */
                                      1,                              /* not global */
                                      1,                              /* access flag */
@@ -287,8 +303,7 @@ map_it_pt_cap(cap_t vspace_cap, cap_t pt_cap)
 
     pgd += GET_PGD_INDEX(vptr);
     assert(pgde_ptr_get_present(pgd));
-    pud = paddr_to_pptr(pgde_ptr_get_pud_base_address(pgd));
-    pud += GET_PUD_INDEX(vptr);
+    pud = pgdeToPUDSlot(pgd, vptr);
     assert(pude_pude_pd_ptr_get_present(pud));
     pd = paddr_to_pptr(pude_pude_pd_ptr_get_pd_base_address(pud));
     *(pd + GET_PD_INDEX(vptr)) = pde_pde_small_new(
@@ -321,11 +336,13 @@ map_it_pd_cap(cap_t vspace_cap, cap_t pd_cap)
     assert(cap_page_directory_cap_get_capPDIsMapped(pd_cap));
 
     pgd += GET_PGD_INDEX(vptr);
+#ifndef CONFIG_ARM_USER_64K_GRANULE
     assert(pgde_ptr_get_present(pgd));
-    pud = paddr_to_pptr(pgde_ptr_get_pud_base_address(pgd));
-    *(pud + GET_PUD_INDEX(vptr)) = pude_pude_pd_new(
-                                       pptr_to_paddr(pd)
-                                   );
+#endif
+    pud = pgdeToPUDSlot(pgd, vptr);
+    *pud = pude_pude_pd_new(
+               pptr_to_paddr(pd)
+           );
 }
 
 static BOOT_CODE cap_t
@@ -342,6 +359,7 @@ create_it_pd_cap(cap_t vspace_cap, pptr_t pptr, vptr_t vptr, asid_t asid)
     return cap;
 }
 
+#ifndef CONFIG_ARM_USER_64K_GRANULE
 static BOOT_CODE void
 map_it_pud_cap(cap_t vspace_cap, cap_t pud_cap)
 {
@@ -370,6 +388,7 @@ create_it_pud_cap(cap_t vspace_cap, pptr_t pptr, vptr_t vptr, asid_t asid)
     map_it_pud_cap(vspace_cap, cap);
     return cap;
 }
+#endif
 
 BOOT_CODE cap_t
 create_it_address_space(cap_t root_cnode_cap, v_region_t it_v_reg)
@@ -394,6 +413,7 @@ create_it_address_space(cap_t root_cnode_cap, v_region_t it_v_reg)
     slot_pos_before = ndks_boot.slot_pos_cur;
     write_slot(SLOT_PTR(pptr_of_cap(root_cnode_cap), seL4_CapInitThreadVSpace), vspace_cap);
 
+#ifndef CONFIG_ARM_USER_64K_GRANULE
     /* Create any PUDs needed for the user land image */
     for (vptr = ROUND_DOWN(it_v_reg.start, PGD_INDEX_OFFSET);
             vptr < it_v_reg.end;
@@ -407,6 +427,7 @@ create_it_address_space(cap_t root_cnode_cap, v_region_t it_v_reg)
             return cap_null_cap_new();
         }
     }
+#endif
 
     /* Create any PDs needed for the user land image */
     for (vptr = ROUND_DOWN(it_v_reg.start, PUD_INDEX_OFFSET);
@@ -460,12 +481,26 @@ create_mapped_it_frame_cap(cap_t pd_cap, pptr_t pptr, vptr_t vptr, asid_t asid,
 BOOT_CODE void
 activate_kernel_vspace(void)
 {
+    word_t tcr;
+
     cleanInvalidateL1Caches();
     setCurrentKernelVSpaceRoot(ttbr_new(0, pptr_to_paddr(armKSGlobalKernelPGD)));
 
     /* Prevent elf-loader address translation to fill up TLB */
     setCurrentUserVSpaceRoot(ttbr_new(0, pptr_to_paddr(armKSGlobalUserPGD)));
 
+    /* The hardware must not set the access flag or the dirty state in user
+     * PTEs behind the kernel's back: isPTEPermissionUpgrade and
+     * isSpuriousFault compare PTEs word for word. The fields are RES0 before
+     * ARMv8.1, but whatever loaded the kernel may have set them. */
+    tcr = readTranslationControlRegister() & ~(TCR_HA | TCR_HD);
+#ifdef CONFIG_ARM_USER_64K_GRANULE
+    /* Nothing is translated through TTBR0 any more, so its granule can be
+     * switched before the TLB is flushed */
+    tcr = (tcr & ~TCR_TG0_MASK) | TCR_TG0_64K;
+#endif
+    writeTranslationControlRegister(tcr);
+
     invalidateLocalTLB();
     lockTLBEntry(kernelBase);
 }
@@ -581,6 +616,11 @@ static lookupPUDSlot_ret_t lookupPUDSlot(vspace_root_t *vspace, vptr_t vptr)
 
     pgdSlot = lookupPGDSlot(vspace, vptr);
 
+#ifdef CONFIG_ARM_USER_64K_GRANULE
+    ret.status = EXCEPTION_NONE;
+    ret.pudSlot = pgdeToPUDSlot(pgdSlot.pgdSlot, vptr);
+    return ret;
+#else
     if (!pgde_ptr_get_present(pgdSlot.pgdSlot)) {
         current_lookup_fault = lookup_fault_missing_capability_new(PGD_INDEX_OFFSET);
 
@@ -588,16 +628,11 @@ static lookupPUDSlot_ret_t lookupPUDSlot(vspace_root_t *vspace, vptr_t vptr)
         ret.status = EXCEPTION_LOOKUP_FAULT;
         return ret;
     } else {
-        pude_t *pud;
-        pude_t *pudSlot;
-        word_t pudIndex = GET_PUD_INDEX(vptr);
-        pud = paddr_to_pptr(pgde_ptr_get_pud_base_address(pgdSlot.pgdSlot));
-        pudSlot = pud + pudIndex;
-
         ret.status = EXCEPTION_NONE;
-        ret.pudSlot = pudSlot;
+        ret.pudSlot = pgdeToPUDSlot(pgdSlot.pgdSlot, vptr);
         return ret;
     }
+#endif
 }
 
 static lookupPDSlot_ret_t
@@ -718,6 +753,7 @@ makeUser3rdLevel(paddr_t paddr, vm_rights_t vm_rights, vm_attributes_t attribute
     if (vm_attributes_get_armPageCacheable(attributes)) {
         return pte_new(
                    nonexecutable,              /* unprivileged execute never */
+                   0,                          /* contiguous */
                    paddr,
                    1,                          /* not global */
                    1,                          /* access flag */
@@ -729,6 +765,7 @@ makeUser3rdLevel(paddr_t paddr, vm_rights_t vm_rights, vm_attributes_t attribute
     } else {
         return pte_new(
                    nonexecutable,              /* unprivileged execute never */
+                   0,                          /* contiguous */
                    paddr,
                    1,                          /* not global */
                    1,                          /* access flag */
@@ -796,6 +833,88 @@ makeUser1stLevel(paddr_t paddr, vm_rights_t vm_rights, vm_attributes_t attribute
     }
 }
 
+/* Permission fault, any level, in the fault status code of an ESR */
+#define ESR_FSC_MASK        0x3c
+#define ESR_FSC_TRANSLATION 0x04
+#define ESR_FSC_PERMISSION  0x0c
+#define ESR_WNR             BIT(6)
+
+/* A remap that only adds rights does not invalidate the TLB, so a thread can
+ * take a permission fault on a stale entry. A thread on another core can
+ * also take a translation fault on a contiguous run while the kernel has it
+ * invalid to rewrite it. If the tables now allow the access, drop any stale
+ * entry on this core and let the thread retry. */
+static bool_t
+isSpuriousFault(tcb_t *thread, vptr_t addr, word_t esr, bool_t instruction)
+{
+    cap_t threadRoot;
+    lookupPUDSlot_ret_t pudSlot;
+    asid_t asid;
+    word_t ap, uxn;
+
+    if ((esr & ESR_FSC_MASK) != ESR_FSC_PERMISSION &&
+            (esr & ESR_FSC_MASK) != ESR_FSC_TRANSLATION) {
+        return false;
+    }
+
+    /* the user tables would alias kernel addresses */
+    if (addr > USER_TOP) {
+        return false;
+    }
+
+    threadRoot = TCB_PTR_CTE_PTR(thread, tcbVTable)->cap;
+    if (!isValidNativeRoot(threadRoot)) {
+        return false;
+    }
+    asid = cap_page_global_directory_cap_get_capPGDMappedASID(threadRoot);
+
+    pudSlot = lookupPUDSlot(PGDE_PTR(cap_page_global_directory_cap_get_capPGDBasePtr(threadRoot)), addr);
+    if (pudSlot.status != EXCEPTION_NONE) {
+        return false;
+    }
+
+    if (pude_ptr_get_pude_type(pudSlot.pudSlot) == pude_pude_1g) {
+        ap = pude_pude_1g_ptr_get_AP(pudSlot.pudSlot);
+        uxn = pude_pude_1g_ptr_get_UXN(pudSlot.pudSlot);
+    } else if (pude_ptr_get_pude_type(pudSlot.pudSlot) == pude_pude_pd) {
+        pde_t *pd = paddr_to_pptr(pude_pude_pd_ptr_get_pd_base_address(pudSlot.pudSlot));
+        pde_t *pdSlot = pd + GET_PD_INDEX(addr);
+
+        if (pde_ptr_get_pde_type(pdSlot) == pde_pde_large) {
+            ap = pde_pde_large_ptr_get_AP(pdSlot);
+            uxn = pde_pde_large_ptr_get_UXN(pdSlot);
+        } else if (pde_ptr_get_pde_type(pdSlot) == pde_pde_small) {
+            pte_t *pt = paddr_to_pptr(pde_pde_small_ptr_get_pt_base_address(pdSlot));
+            pte_t *ptSlot = pt + GET_PT_INDEX(addr);
+
+            if (!pte_ptr_get_present(ptSlot)) {
+                return false;
+            }
+            ap = pte_ptr_get_AP(ptSlot);
+            uxn = pte_ptr_get_UXN(ptSlot);
+        } else {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    /* AP[1] grants EL0 access, AP[2] makes the page read-only */
+    if (!(ap & BIT(0))) {
+        return false;
+    }
+    if (instruction ? uxn : ((esr & ESR_WNR) && (ap & BIT(1)))) {
+        return false;
+    }
+
+    /* invalid entries are never held in the TLB */
+    if ((esr & ESR_FSC_MASK) == ESR_FSC_PERMISSION) {
+        assert(asid < BIT(16));
+        invalidateLocalTLB_VAASID((asid << 48) | (addr >> TLBI_VADDR_SHIFT));
+    }
+    return true;
+}
+
 exception_t
 handleVMFault(tcb_t *thread, vm_fault_type_t vm_faultType)
 {
@@ -805,6 +924,9 @@ handleVMFault(tcb_t *thread, vm_fault_type_t vm_faultType)
 
         addr = getFAR();
         fault = getDFSR();
+        if (isSpuriousFault(thread, addr, fault, false)) {
+            return EXCEPTION_NONE;
+        }
         current_fault = seL4_Fault_VMFault_new(addr, fault, false);
         return EXCEPTION_FAULT;
     }
@@ -814,6 +936,9 @@ handleVMFault(tcb_t *thread, vm_fault_type_t vm_faultType)
 
         pc = getRestartPC(thread);
         fault = getIFSR();
+        if (isSpuriousFault(thread, pc, fault, true)) {
+            return EXCEPTION_NONE;
+        }
         current_fault = seL4_Fault_VMFault_new(pc, fault, true);
         return EXCEPTION_FAULT;
     }
@@ -989,6 +1114,79 @@ void unmapPageTable(asid_t asid, vptr_t vaddr, pte_t *pt)
     }
 }
 
+/* Returns the first PTE of the aligned run that contains ptSlot */
+static inline pte_t *
+contiguousRunBase(pte_t *ptSlot)
+{
+    return (pte_t *)ROUND_DOWN((word_t)ptSlot, PT_CONTIGUOUS_BITS + PTE_SIZE_BITS);
+}
+
+/* Rewrites every entry of the run mapping vptr with the contiguous hint set
+ * to the given value. The hint may only change with the whole run invalid
+ * and flushed from the TLB, so the entries go through break-before-make.
+ * Only the pages of the run are flushed, by a broadcast TLBI rather than a
+ * shootdown. Other cores that fault on the run meanwhile retry once the
+ * kernel is done, see isSpuriousFault. */
+static void
+rewriteContiguousRun(asid_t asid, vptr_t vptr, pte_t *run, bool_t contiguous)
+{
+    pte_t pte = pte_set_contiguous(run[0], contiguous);
+    paddr_t base = pte_get_page_base_address(pte);
+    vptr_t runBase = ROUND_DOWN(vptr, PT_CONTIGUOUS_BITS + seL4_PageBits);
+    word_t i;
+
+    for (i = 0; i < BIT(PT_CONTIGUOUS_BITS); i++) {
+        run[i] = pte_invalid_new();
+    }
+    cleanCacheRange_PoU((word_t)run, (word_t)(run + BIT(PT_CONTIGUOUS_BITS)) - 1,
+                        pptr_to_paddr(run));
+    assert(asid < BIT(16));
+    invalidateTLB_VAASIDRange_IS((asid << 48) | (runBase >> TLBI_VADDR_SHIFT),
+                                 BIT(PT_CONTIGUOUS_BITS),
+                                 BIT(seL4_PageBits - TLBI_VADDR_SHIFT));
+
+    for (i = 0; i < BIT(PT_CONTIGUOUS_BITS); i++) {
+        run[i] = pte_set_page_base_address(pte, base + (i << seL4_PageBits));
+    }
+    cleanCacheRange_PoU((word_t)run, (word_t)(run + BIT(PT_CONTIGUOUS_BITS)) - 1,
+                        pptr_to_paddr(run));
+}
+
+/* Clears the contiguous hint from the run containing ptSlot, which maps
+ * vptr, so that one of its entries can be changed on its own */
+static inline void
+breakContiguousRun(asid_t asid, vptr_t vptr, pte_t *ptSlot)
+{
+    if (pte_ptr_get_contiguous(ptSlot)) {
+        rewriteContiguousRun(asid, vptr, contiguousRunBase(ptSlot), false);
+    }
+}
+
+/* Sets the contiguous hint on the run containing ptSlot if every entry of it
+ * is present, the run maps an aligned physically contiguous region and all
+ * entries have the same attributes */
+static void
+makeContiguousRun(asid_t asid, vptr_t vptr, pte_t *ptSlot)
+{
+    pte_t *run = contiguousRunBase(ptSlot);
+    paddr_t base = pte_ptr_get_page_base_address(run);
+    word_t i;
+
+    if (!pte_ptr_get_present(run) || pte_ptr_get_contiguous(run) ||
+            !IS_ALIGNED(base, PT_CONTIGUOUS_BITS + seL4_PageBits)) {
+        return;
+    }
+
+    for (i = 1; i < BIT(PT_CONTIGUOUS_BITS); i++) {
+        pte_t expected = pte_set_page_base_address(run[0], base + (i << seL4_PageBits));
+        if (run[i].words[0] != expected.words[0]) {
+            return;
+        }
+    }
+
+    rewriteContiguousRun(asid, vptr, run, true);
+}
+
 void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
 {
     paddr_t addr;
@@ -1011,6 +1209,7 @@ void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
 
         if (pte_ptr_get_present(lu_ret.ptSlot) &&
                 pte_ptr_get_page_base_address(lu_ret.ptSlot) == addr) {
+            breakContiguousRun(asid, vptr, lu_ret.ptSlot);
             *(lu_ret.ptSlot) = pte_invalid_new();
 
             cleanByVA_PoU((vptr_t)lu_ret.ptSlot, pptr_to_paddr(lu_ret.ptSlot));
@@ -1057,7 +1256,7 @@ void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
     }
 
     assert(asid < BIT(16));
-    invalidateTranslationSingle((asid << 48) | vptr >> seL4_PageBits);
+    invalidateTranslationSingle((asid << 48) | vptr >> TLBI_VADDR_SHIFT);
 }
 
 void
@@ -1219,11 +1418,62 @@ performPageTableInvocationUnmap(cap_t cap, cte_t *ctSlot)
     return EXCEPTION_NONE;
 }
 
+/* Whether replacing an entry with AP oldAP by one with newAP takes no
+ * access away at either exception level */
+static inline bool_t CONST
+isAPUpgrade(word_t oldAP, word_t newAP)
+{
+    return !(newAP & ~oldAP & BIT(1)) && !(oldAP & ~newAP & BIT(0));
+}
+
+/* Remapping the same frame with the same attributes and only more rights
+ * does not need a TLB invalidate: an access a stale entry denies takes a
+ * permission fault, which handleVMFault retries. */
+static bool_t
+isPTEPermissionUpgrade(pte_t *ptSlot, pte_t pte)
+{
+    if (!pte_ptr_get_present(ptSlot) ||
+            !isAPUpgrade(pte_ptr_get_AP(ptSlot), pte_get_AP(pte)) ||
+            pte_get_UXN(pte) > pte_ptr_get_UXN(ptSlot)) {
+        return false;
+    }
+    pte = pte_set_AP(pte, pte_ptr_get_AP(ptSlot));
+    pte = pte_set_UXN(pte, pte_ptr_get_UXN(ptSlot));
+    return pte.words[0] == ptSlot->words[0];
+}
+
+static bool_t
+isPDEPermissionUpgrade(pde_t *pdSlot, pde_t pde)
+{
+    if (!pde_pde_large_ptr_get_present(pdSlot) ||
+            !isAPUpgrade(pde_pde_large_ptr_get_AP(pdSlot), pde_pde_large_get_AP(pde)) ||
+            pde_pde_large_get_UXN(pde) > pde_pde_large_ptr_get_UXN(pdSlot)) {
+        return false;
+    }
+    pde = pde_pde_large_set_AP(pde, pde_pde_large_ptr_get_AP(pdSlot));
+    pde = pde_pde_large_set_UXN(pde, pde_pde_large_ptr_get_UXN(pdSlot));
+    return pde.words[0] == pdSlot->words[0];
+}
+
+static bool_t
+isPUDEPermissionUpgrade(pude_t *pudSlot, pude_t pude)
+{
+    if (!pude_pude_1g_ptr_get_present(pudSlot) ||
+            !isAPUpgrade(pude_pude_1g_ptr_get_AP(pudSlot), pude_pude_1g_get_AP(pude)) ||
+            pude_pude_1g_get_UXN(pude) > pude_pude_1g_ptr_get_UXN(pudSlot)) {
+        return false;
+    }
+    pude = pude_pude_1g_set_AP(pude, pude_pude_1g_ptr_get_AP(pudSlot));
+    pude = pude_pude_1g_set_UXN(pude, pude_pude_1g_ptr_get_UXN(pudSlot));
+    return pude.words[0] == pudSlot->words[0];
+}
+
 static exception_t
 performHugePageInvocationMap(asid_t asid, cap_t cap, cte_t *ctSlot,
                              pude_t pude, pude_t *pudSlot)
 {
-    bool_t tlbflush_required = pude_pude_1g_ptr_get_present(pudSlot);
+    bool_t tlbflush_required = pude_pude_1g_ptr_get_present(pudSlot) &&
+                               !isPUDEPermissionUpgrade(pudSlot, pude);
 
     ctSlot->cap = cap;
     *pudSlot = pude;
@@ -1232,7 +1482,7 @@ performHugePageInvocationMap(asid_t asid, cap_t cap, cte_t *ctSlot,
     if (unlikely(tlbflush_required)) {
         assert(asid < BIT(16));
         invalidateTranslationSingle((asid << 48) |
-                                    cap_frame_cap_get_capFMappedAddress(cap) >> seL4_PageBits);
+                                    cap_frame_cap_get_capFMappedAddress(cap) >> TLBI_VADDR_SHIFT);
     }
 
     return EXCEPTION_NONE;
@@ -1242,7 +1492,8 @@ static exception_t
 performLargePageInvocationMap(asid_t asid, cap_t cap, cte_t *ctSlot,
                               pde_t pde, pde_t *pdSlot)
 {
-    bool_t tlbflush_required = pde_pde_large_ptr_get_present(pdSlot);
+    bool_t tlbflush_required = pde_pde_large_ptr_get_present(pdSlot) &&
+                               !isPDEPermissionUpgrade(pdSlot, pde);
 
     ctSlot->cap = cap;
     *pdSlot = pde;
@@ -1251,7 +1502,7 @@ performLargePageInvocationMap(asid_t asid, cap_t cap, cte_t *ctSlot,
     if (unlikely(tlbflush_required)) {
         assert(asid < BIT(16));
         invalidateTranslationSingle((asid << 48) |
-                                    cap_frame_cap_get_capFMappedAddress(cap) >> seL4_PageBits);
+                                    cap_frame_cap_get_capFMappedAddress(cap) >> TLBI_VADDR_SHIFT);
     }
 
     return EXCEPTION_NONE;
@@ -1261,7 +1512,11 @@ static exception_t
 performSmallPageInvocationMap(asid_t asid, cap_t cap, cte_t *ctSlot,
                               pte_t pte, pte_t *ptSlot)
 {
-    bool_t tlbflush_required = pte_ptr_get_present(ptSlot);
+    bool_t tlbflush_required;
+
+    breakContiguousRun(asid, cap_frame_cap_get_capFMappedAddress(cap), ptSlot);
+    tlbflush_required = pte_ptr_get_present(ptSlot) &&
+                        !isPTEPermissionUpgrade(ptSlot, pte);
 
     ctSlot->cap = cap;
     *ptSlot = pte;
@@ -1270,8 +1525,9 @@ performSmallPageInvocationMap(asid_t asid, cap_t cap, cte_t *ctSlot,
     if (unlikely(tlbflush_required)) {
         assert(asid < BIT(16));
         invalidateTranslationSingle((asid << 48) |
-                                    cap_frame_cap_get_capFMappedAddress(cap) >> seL4_PageBits);
+                                    cap_frame_cap_get_capFMappedAddress(cap) >> TLBI_VADDR_SHIFT);
     }
+    makeContiguousRun(asid, cap_frame_cap_get_capFMappedAddress(cap), ptSlot);
 
     return EXCEPTION_NONE;
 }
@@ -1478,6 +1734,12 @@ decodeARMPageUpperDirectoryInvocation(word_t invLabel, unsigned int length,
         return EXCEPTION_SYSCALL_ERROR;
     }
 
+#ifdef CONFIG_ARM_USER_64K_GRANULE
+    userError("ARMPageUpperDirectoryMap: There is no PUD level with the 64K granule.");
+    current_syscall_error.type = seL4_IllegalOperation;
+    return EXCEPTION_SYSCALL_ERROR;
+#endif
+
     if (unlikely(length < 2 || extraCaps.excaprefs[0] == NULL)) {
         current_syscall_error.type = seL4_TruncatedMessage;
         return EXCEPTION_SYSCALL_ERROR;
@@ -1764,6 +2026,14 @@ decodeARMFrameInvocation(word_t invLabel, unsigned int length,
         vmRights = maskVMRights(cap_frame_cap_get_capFVMRights(cap),
                                 rightsFromWord(getSyscallArg(1, buffer)));
 
+#ifdef CONFIG_ARM_USER_64K_GRANULE
+        if (unlikely(frameSize == ARMHugePage)) {
+            userError("ARMPageMap: Huge pages cannot be mapped with the 64K granule.");
+            current_syscall_error.type = seL4_IllegalOperation;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+#endif
+
         if (unlikely(!isValidNativeRoot(pgdCap))) {
             current_syscall_error.type = seL4_InvalidCapability;
             current_syscall_error.invalidCapNumber = 1;
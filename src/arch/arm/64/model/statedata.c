@@ -22,8 +22,8 @@
 asid_pool_t *armKSASIDTable[BIT(asidHighBits)];
 
 pgde_t armKSGlobalUserPGD[BIT(PGD_INDEX_BITS)] ALIGN_BSS(BIT(seL4_PGDBits));
-pgde_t armKSGlobalKernelPGD[BIT(PGD_INDEX_BITS)] ALIGN_BSS(BIT(seL4_PGDBits));
+pgde_t armKSGlobalKernelPGD[BIT(KERNEL_TABLE_INDEX_BITS)] ALIGN_BSS(BIT(KERNEL_TABLE_BITS));
 
-pude_t armKSGlobalKernelPUD[BIT(PUD_INDEX_BITS)] ALIGN_BSS(BIT(seL4_PUDBits));
-pde_t armKSGlobalKernelPDs[BIT(PUD_INDEX_BITS)][BIT(PD_INDEX_BITS)] ALIGN_BSS(BIT(seL4_PageDirBits));
-pte_t armKSGlobalKernelPT[BIT(PT_INDEX_BITS)] ALIGN_BSS(BIT(seL4_PageTableBits));
+pude_t armKSGlobalKernelPUD[BIT(KERNEL_TABLE_INDEX_BITS)] ALIGN_BSS(BIT(KERNEL_TABLE_BITS));
+pde_t armKSGlobalKernelPDs[BIT(KERNEL_TABLE_INDEX_BITS)][BIT(KERNEL_TABLE_INDEX_BITS)] ALIGN_BSS(BIT(KERNEL_TABLE_BITS));
+pte_t armKSGlobalKernelPT[BIT(KERNEL_TABLE_INDEX_BITS)] ALIGN_BSS(BIT(KERNEL_TABLE_BITS));
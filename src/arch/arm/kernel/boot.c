@@ -183,6 +183,27 @@ init_irqs(cap_t root_cnode_cap)
     write_slot(SLOT_PTR(pptr_of_cap(root_cnode_cap), seL4_CapIRQControl), cap_irq_control_cap_new());
 }
 
+#ifdef CONFIG_ARM_USER_64K_GRANULE
+/* Device regions are listed in 4K frames, but user level can only map them
+ * with 64K pages. Rounding a region out would hand out registers that are
+ * not in the list, possibly including ones the kernel uses, so a region that
+ * does not start and end on a 64K boundary is left out instead. */
+BOOT_CODE static p_region_t
+get_dev_p_reg_pages(word_t i)
+{
+    p_region_t reg = get_dev_p_reg(i);
+
+    if (!IS_ALIGNED(reg.start, PAGE_BITS) || !IS_ALIGNED(reg.end, PAGE_BITS)) {
+        printf("Device region 0x%lx..0x%lx is not 64K aligned, not providing an untyped for it\n",
+               (unsigned long)reg.start, (unsigned long)reg.end);
+        return (p_region_t) {
+            0, 0
+        };
+    }
+    return reg;
+}
+#endif /* CONFIG_ARM_USER_64K_GRANULE */
+
 BOOT_CODE static bool_t
 create_untypeds(cap_t root_cnode_cap, region_t boot_mem_reuse_reg)
 {
@@ -194,7 +215,11 @@ create_untypeds(cap_t root_cnode_cap, region_t boot_mem_reuse_reg)
     slot_pos_before = ndks_boot.slot_pos_cur;
     create_kernel_untypeds(root_cnode_cap, boot_mem_reuse_reg, slot_pos_before);
     for (i = 0; i < get_num_dev_p_regs(); i++) {
+#ifdef CONFIG_ARM_USER_64K_GRANULE
+        dev_reg = paddr_to_pptr_reg(get_dev_p_reg_pages(i));
+#else
         dev_reg = paddr_to_pptr_reg(get_dev_p_reg(i));
+#endif
         if (!create_untypeds_for_region(root_cnode_cap, true,
                                         dev_reg, slot_pos_before)) {
             return false;
@@ -356,6 +381,11 @@ try_init_kernel(
     ui_v_reg.start = ui_p_reg_start - pv_offset;
     ui_v_reg.end   = ui_p_reg_end   - pv_offset;
 
+    if (!IS_ALIGNED(ui_v_reg.start, PAGE_BITS) || !IS_ALIGNED(ui_v_reg.end, PAGE_BITS)) {
+        printf("Userland image is not aligned to the page size\n");
+        return false;
+    }
+
     ipcbuf_vptr = ui_v_reg.end;
     bi_frame_vptr = ipcbuf_vptr + BIT(PAGE_BITS);
 
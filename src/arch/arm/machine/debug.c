@@ -24,6 +24,7 @@
 #include <mode/machine/debug.h>
 #include <plat/machine/devices.h>
 #include <api/constants.h> /* seL4_NumExclusiveBreakpoints/Watchpoints */
+#include <model/kernel_stats.h>
 
 #define DBGDSCR_MDBGEN                (BIT(15))
 #define DBGDSCR_HDBGEN                (BIT(14))
@@ -1111,6 +1112,7 @@ handleUserLevelDebugException(word_t fault_vaddr)
     ksKernelEntry.path = Entry_DebugFault;
     ksKernelEntry.word = fault_vaddr;
 #endif
+    KERNEL_STATS_INC(seL4_KernelStats_DebugFaults);
 
     word_t method_of_entry = getMethodOfEntry();
     int i, active_bp;
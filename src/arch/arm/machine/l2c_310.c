@@ -38,6 +38,9 @@ compile_assert(l2_l1_same_line_size, L2_LINE_SIZE_BITS == L1_CACHE_LINE_SIZE_BIT
 #define PL310_LOCKDOWN_BY_MASTER          (0xe<<25)
 #define PL310_LOCKDOWN_BY_LINE            (0xf<<25)
 
+#define PL310_RTL_RELEASE_MASK            0x3f
+#define PL310_RTL_R3P1                    0x6
+
 /* Primary control */
 #define CTRL_CTRL_EN BIT(0)
 
@@ -382,17 +385,33 @@ void plat_cleanCache(void)
 #endif /* !CONFIG_DEBUG_DISABLE_L2_CACHE */
 }
 
+#ifndef CONFIG_DEBUG_DISABLE_L2_CACHE
+/* Operating on every way costs about as much as walking a range the size of
+ * the cache, so large ranges are cheaper to maintain by way */
+static inline bool_t L2_useWayMaintenance(paddr_t start, paddr_t end)
+{
+    return CONFIG_ARM_L2_WAY_MAINTENANCE_THRESHOLD != 0 &&
+           end - start >= CONFIG_ARM_L2_WAY_MAINTENANCE_THRESHOLD * BIT(10) - 1;
+}
+#endif /* !CONFIG_DEBUG_DISABLE_L2_CACHE */
+
 void plat_cleanL2Range(paddr_t start, paddr_t end)
 {
 #ifndef CONFIG_DEBUG_DISABLE_L2_CACHE
     /* Documentation specifies this as the only possible line size */
     assert(((l2cc->id.cache_type >> 12) & 0x3) == 0x0);
 
-    for (start = L2_LINE_START(start);
-            start != L2_LINE_START(end + L2_LINE_SIZE);
-            start += L2_LINE_SIZE) {
-        l2cc->maintenance.clean_pa = start;
-        /* do not need to wait for every invalidate as 310 is atomic */
+    if (L2_useWayMaintenance(start, end)) {
+        /* Cleaning lines outside the range only writes back data early */
+        l2cc->maintenance.clean_way = 0xffff;
+        while (l2cc->maintenance.clean_way & 0xffff);
+    } else {
+        for (start = L2_LINE_START(start);
+                start != L2_LINE_START(end + L2_LINE_SIZE);
+                start += L2_LINE_SIZE) {
+            l2cc->maintenance.clean_pa = start;
+            /* do not need to wait for every invalidate as 310 is atomic */
+        }
     }
     L2_cacheSync();
 #endif /* !CONFIG_DEBUG_DISABLE_L2_CACHE */
@@ -405,7 +424,11 @@ void plat_invalidateL2Range(paddr_t start, paddr_t end)
     assert(((l2cc->id.cache_type >> 12) & 0x3) == 0x0);
 
     /* We assume that if this is a partial line that whoever is calling us
-     * has already done the clean, so we just blindly invalidate all the lines */
+     * has already done the clean, so we just blindly invalidate all the lines.
+     * There is no cut-over to maintenance by way here: invalidating by way
+     * would throw away dirty lines outside the range, and clean-invalidating
+     * by way would write dirty lines inside it back over the new contents
+     * of memory. */
 
     for (start = L2_LINE_START(start);
             start != L2_LINE_START(end + L2_LINE_SIZE);
@@ -420,17 +443,27 @@ void plat_invalidateL2Range(paddr_t start, paddr_t end)
 void plat_cleanInvalidateL2Range(paddr_t start, paddr_t end)
 {
 #ifndef CONFIG_DEBUG_DISABLE_L2_CACHE
+    uint32_t revision = l2cc->id.cache_id & PL310_RTL_RELEASE_MASK;
+
     /* Documentation specifies this as the only possible line size */
     assert(((l2cc->id.cache_type >> 12) & 0x3) == 0x0);
 
-    for (start = L2_LINE_START(start);
-            start != L2_LINE_START(end + L2_LINE_SIZE);
-            start += L2_LINE_SIZE) {
-        /* Work around an errata and call the clean and invalidate separately */
-        l2cc->maintenance.clean_pa = start;
-        dmb();
-        l2cc->maintenance.inv_pa = start;
-        /* do not need to wait for every invalidate as 310 is atomic */
+    /* Clean and invalidate by way is only used from r3p1 on: before r2p0 it
+     * leaves clean lines valid (erratum 588369), and up to r3p0 the
+     * background operation can corrupt data (erratum 727915) */
+    if (L2_useWayMaintenance(start, end) && revision >= PL310_RTL_R3P1) {
+        l2cc->maintenance.clean_inv_way = 0xffff;
+        while (l2cc->maintenance.clean_inv_way & 0xffff);
+    } else {
+        for (start = L2_LINE_START(start);
+                start != L2_LINE_START(end + L2_LINE_SIZE);
+                start += L2_LINE_SIZE) {
+            /* Work around an errata and call the clean and invalidate separately */
+            l2cc->maintenance.clean_pa = start;
+            dmb();
+            l2cc->maintenance.inv_pa = start;
+            /* do not need to wait for every invalidate as 310 is atomic */
+        }
     }
     L2_cacheSync();
 #endif /* !CONFIG_DEBUG_DISABLE_L2_CACHE */
@@ -16,6 +16,7 @@
 #include <plat/machine/devices.h>
 #include <arch/machine/debug.h> /* Arch_debug[A/Di]ssociateVCPUTCB() */
 #include <arch/machine/debug_conf.h>
+#include <model/kernel_stats.h>
 
 #define HCR_TGE      BIT(27)     /* Trap general exceptions        */
 #define HCR_TVM      BIT(26)     /* Trap MMU access                */
@@ -1148,6 +1149,7 @@ invokeVCPUSetTCB(vcpu_t *vcpu, tcb_t *tcb)
 void
 handleVCPUFault(word_t hsr)
 {
+    KERNEL_STATS_INC(seL4_KernelStats_VMExits);
     current_fault = seL4_Fault_VCPUFault_new(hsr);
     handleFault(ksCurThread);
     schedule();
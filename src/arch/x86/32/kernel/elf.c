@@ -56,8 +56,45 @@ elf_getMemoryBounds(Elf32_Header_t* elfFile)
     return elf_reg;
 }
 
+/* Zero the parts of [start, end) that are not covered by any segment */
+BOOT_CODE static void
+elf_zeroGaps(Elf32_Header_t* elfFile, vptr_t start, vptr_t end, seL4_Word offset)
+{
+    Elf32_Phdr_t* phdr = (Elf32_Phdr_t*)((paddr_t)elfFile + elfFile->e_phoff);
+    vptr_t        gap_end;
+    vptr_t        sect_start;
+    vptr_t        sect_end;
+    bool_t        covered;
+    uint32_t      i;
+
+    while (start < end) {
+        covered = false;
+        gap_end = end;
+        for (i = 0; i < elfFile->e_phnum; i++) {
+            if (phdr[i].p_memsz == 0) {
+                continue;
+            }
+            sect_start = phdr[i].p_vaddr;
+            sect_end = sect_start + phdr[i].p_memsz;
+            if (sect_start <= start && start < sect_end) {
+                /* skip over the segment, it is initialised by elf_load */
+                start = sect_end;
+                covered = true;
+                break;
+            }
+            if (sect_start > start && sect_start < gap_end) {
+                gap_end = sect_start;
+            }
+        }
+        if (!covered) {
+            memzero((void*)(start + offset), gap_end - start);
+            start = gap_end;
+        }
+    }
+}
+
 BOOT_CODE void
-elf_load(Elf32_Header_t* elfFile, seL4_Word offset)
+elf_load(Elf32_Header_t* elfFile, v_region_t v_reg, seL4_Word offset)
 {
     Elf32_Phdr_t* phdr = (Elf32_Phdr_t*)((paddr_t)elfFile + elfFile->e_phoff);
     paddr_t       src;
@@ -65,6 +102,9 @@ elf_load(Elf32_Header_t* elfFile, seL4_Word offset)
     uint32_t      len;
     uint32_t      i;
 
+    /* zero the parts of the image not covered by a segment */
+    elf_zeroGaps(elfFile, v_reg.start, v_reg.end, offset);
+
     /* loop through all program headers (segments) and load them */
     for (i = 0; i < elfFile->e_phnum; i++) {
         src = (paddr_t)elfFile + phdr[i].p_offset;
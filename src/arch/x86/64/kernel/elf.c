@@ -54,8 +54,45 @@ elf_getMemoryBounds(Elf64_Header_t *elf)
     return elf_reg;
 }
 
+/* Zero the parts of [start, end) that are not covered by any segment */
+BOOT_CODE static void
+elf_zeroGaps(Elf64_Header_t *elf, vptr_t start, vptr_t end, seL4_Word offset)
+{
+    vptr_t      gap_end;
+    vptr_t      sect_start;
+    vptr_t      sect_end;
+    bool_t      covered;
+    uint32_t    i;
+    Elf64_Phdr_t *phdr = (Elf64_Phdr_t *)((paddr_t)elf + elf->e_phoff);
+
+    while (start < end) {
+        covered = false;
+        gap_end = end;
+        for (i = 0; i < elf->e_phnum; i++) {
+            if (phdr[i].p_memsz == 0) {
+                continue;
+            }
+            sect_start = phdr[i].p_vaddr;
+            sect_end = sect_start + phdr[i].p_memsz;
+            if (sect_start <= start && start < sect_end) {
+                /* skip over the segment, it is initialised by elf_load */
+                start = sect_end;
+                covered = true;
+                break;
+            }
+            if (sect_start > start && sect_start < gap_end) {
+                gap_end = sect_start;
+            }
+        }
+        if (!covered) {
+            memzero((void *)(start + offset), gap_end - start);
+            start = gap_end;
+        }
+    }
+}
+
 BOOT_CODE void
-elf_load(Elf64_Header_t *elf, seL4_Word offset)
+elf_load(Elf64_Header_t *elf, v_region_t v_reg, seL4_Word offset)
 {
     paddr_t     src;
     paddr_t     dst;
@@ -63,6 +100,10 @@ elf_load(Elf64_Header_t *elf, seL4_Word offset)
     uint32_t    i;
     Elf64_Phdr_t *phdr = (Elf64_Phdr_t *)((paddr_t)elf + elf->e_phoff);
 
+    /* every byte of v_reg is written exactly once (modulo overlapping
+     * segments): segments are copied, their BSS and the gaps zeroed */
+    elf_zeroGaps(elf, v_reg.start, v_reg.end, offset);
+
     for (i = 0; i < elf->e_phnum; i++) {
         src = (paddr_t)elf + phdr[i].p_offset;
         dst = phdr[i].p_vaddr + offset;
@@ -20,6 +20,11 @@
 #include <arch/api/invocation.h>
 #include <mode/kernel/tlb.h>
 #include <arch/kernel/tlb_bitmap.h>
+#include <model/preemption.h>
+#ifdef CONFIG_VTX
+#include <arch/kernel/ept.h>
+#include <arch/object/vcpu.h>
+#endif
 
 struct lookupPML4Slot_ret {
     exception_t status;
@@ -787,7 +792,7 @@ performASIDPoolInvocation(asid_t asid, asid_pool_t *poolPtr, cte_t *vspaceCapSlo
 #ifdef CONFIG_VTX
         cap_ept_pml4_cap_ptr_set_capPML4MappedASID(&vspaceCapSlot->cap, asid);
         cap_ept_pml4_cap_ptr_set_capPML4IsMapped(&vspaceCapSlot->cap, 1);
-        asid_map = asid_map_asid_map_ept_new(cap_ept_pml4_cap_get_capPML4BasePtr(vspaceCapSlot->cap));
+        asid_map = asid_map_asid_map_ept_new(cap_ept_pml4_cap_get_capPML4BasePtr(vspaceCapSlot->cap), 0);
 #endif
     } else {
         assert(cap_get_capType(vspaceCapSlot->cap) == cap_pml4_cap);
@@ -1399,6 +1404,273 @@ decodeX64PDPTInvocation(
     return performX64PDPTInvocationMap(cap, cte, pml4e, pml4Slot.pml4Slot, vspace);
 }
 
+/* Accessed and dirty bits, at the same position at every level */
+#define X86_ENTRY_ACCESSED  BIT(5)
+#define X86_ENTRY_DIRTY     BIT(6)
+
+static inline word_t
+pagesToBoundary(vptr_t vaddr, word_t bits)
+{
+    return (BIT(bits) - (vaddr & MASK(bits))) >> seL4_PageBits;
+}
+
+static harvestStatus_ret_t
+harvestStatusBits(vspace_root_t *vspace, vptr_t vaddr, word_t flags)
+{
+    harvestStatus_ret_t ret;
+    lookupPDPTSlot_ret_t pdpt_ret;
+    pdpte_t *pdptSlot;
+    pde_t *pdSlot;
+    pte_t *ptSlot;
+    word_t mask;
+
+    mask = ((flags & X86_STATUS_ACCESSED) ? X86_ENTRY_ACCESSED : 0) |
+           ((flags & X86_STATUS_DIRTY) ? X86_ENTRY_DIRTY : 0);
+    ret.mapped = false;
+    ret.set = false;
+
+    pdpt_ret = lookupPDPTSlot(vspace, vaddr);
+    if (pdpt_ret.status != EXCEPTION_NONE) {
+        ret.pages = pagesToBoundary(vaddr, seL4_HugePageBits + seL4_PDPTIndexBits);
+        return ret;
+    }
+    pdptSlot = pdpt_ret.pdptSlot;
+
+    ret.pages = pagesToBoundary(vaddr, seL4_HugePageBits);
+    if (pdpte_ptr_get_page_size(pdptSlot) == pdpte_pdpte_1g) {
+        if (pdpte_pdpte_1g_ptr_get_present(pdptSlot)) {
+            ret.mapped = true;
+            ret.set = testAndClearEntryBits(&pdptSlot->words[0], mask);
+        }
+        return ret;
+    }
+    if (!pdpte_pdpte_pd_ptr_get_present(pdptSlot)) {
+        return ret;
+    }
+    pdSlot = (pde_t *)paddr_to_pptr(pdpte_pdpte_pd_ptr_get_pd_base_address(pdptSlot)) +
+             GET_PD_INDEX(vaddr);
+
+    ret.pages = pagesToBoundary(vaddr, seL4_LargePageBits);
+    if (pde_ptr_get_page_size(pdSlot) == pde_pde_large) {
+        if (pde_pde_large_ptr_get_present(pdSlot)) {
+            ret.mapped = true;
+            ret.set = testAndClearEntryBits(&pdSlot->words[0], mask);
+        }
+        return ret;
+    }
+    if (!pde_pde_small_ptr_get_present(pdSlot)) {
+        return ret;
+    }
+    ptSlot = (pte_t *)paddr_to_pptr(pde_pde_small_ptr_get_pt_base_address(pdSlot)) +
+             GET_PT_INDEX(vaddr);
+
+    ret.pages = 1;
+    if (pte_ptr_get_present(ptSlot)) {
+        ret.mapped = true;
+        ret.set = testAndClearEntryBits(&ptSlot->words[0], mask);
+    }
+    return ret;
+}
+
+/* A preempted harvest rewrites its flags argument in the caller's message
+ * registers, so the restarted invocation picks up at the next page */
+compile_assert(harvest_flags_in_register, n_msgRegisters > 2)
+
+static void
+harvestBitmapFill(word_t *bitmap, word_t first, word_t count, bool_t set)
+{
+    word_t bit, n, mask;
+
+    while (count > 0) {
+        bit = first % wordBits;
+        n = MIN(count, wordBits - bit);
+        mask = (n == wordBits) ? ~(word_t)0 : MASK(n) << bit;
+        if (set) {
+            bitmap[first / wordBits] |= mask;
+        } else {
+            bitmap[first / wordBits] &= ~mask;
+        }
+        first += n;
+        count -= n;
+    }
+}
+
+static exception_t
+performX86HarvestStatusBits(cap_t cap, void *root, vptr_t vaddr, word_t pages,
+                            word_t flags, word_t *bitmap, word_t next)
+{
+    harvestStatus_ret_t ret;
+    word_t n;
+    bool_t cleared;
+    exception_t status;
+
+    cleared = false;
+    status = EXCEPTION_NONE;
+    while (next < pages) {
+#ifdef CONFIG_VTX
+        if (cap_get_capType(cap) == cap_ept_pml4_cap) {
+            ret = eptHarvestStatusBits(root, vaddr + (next << seL4_PageBits), flags);
+        } else
+#endif
+        {
+            ret = harvestStatusBits(root, vaddr + (next << seL4_PageBits), flags);
+        }
+
+        n = MIN(ret.pages, pages - next);
+        if (!ret.mapped) {
+            /* keep the time between preemption points bounded across
+             * large unmapped regions */
+            n = MIN(n, BIT(seL4_PageTableIndexBits));
+        }
+        harvestBitmapFill(bitmap, next, n, ret.set);
+        cleared |= ret.set;
+        next += n;
+
+        status = preemptionPoint();
+        if (unlikely(status != EXCEPTION_NONE)) {
+            setRegister(NODE_STATE(ksCurThread), msgRegisters[2],
+                        flags | (next << X86_STATUS_RESUME_SHIFT));
+            break;
+        }
+    }
+
+    /* Cached translations may still carry the bits that were cleared, and the
+     * processor would not set them again, so flush once for the whole range.
+     * This is also done before being preempted, as the invocation may never
+     * be restarted. */
+    if (cleared) {
+#ifdef CONFIG_VTX
+        if (cap_get_capType(cap) == cap_ept_pml4_cap) {
+            invept(root);
+        } else
+#endif
+        {
+            invalidatePageStructureCacheASID(pptr_to_paddr(root),
+                                             cap_pml4_cap_get_capPML4MappedASID(cap),
+                                             SMP_TERNARY(tlb_bitmap_get(root), 0));
+        }
+    }
+
+    return status;
+}
+
+exception_t
+decodeX86HarvestStatusBits(word_t invLabel, word_t length, cap_t cap,
+                           extra_caps_t excaps, word_t *buffer)
+{
+    vptr_t vaddr, top;
+    word_t pages, flags, next;
+    word_t *bitmap;
+    void *root;
+    cap_t frameCap;
+
+    if (cap_get_capType(cap) == cap_pml4_cap) {
+        if (invLabel != X64PML4HarvestStatusBits) {
+            current_syscall_error.type = seL4_IllegalOperation;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        if (!isValidNativeRoot(cap)) {
+            userError("X86 HarvestStatusBits: PML4 is not assigned to an ASID.");
+            current_syscall_error.type = seL4_InvalidCapability;
+            current_syscall_error.invalidCapNumber = 0;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        root = (void *)cap_pml4_cap_get_capPML4BasePtr(cap);
+        top = PPTR_USER_TOP;
+    } else {
+#ifdef CONFIG_VTX
+        assert(cap_get_capType(cap) == cap_ept_pml4_cap);
+        if (invLabel != X86EPTPML4HarvestStatusBits) {
+            current_syscall_error.type = seL4_IllegalOperation;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        if (!vtx_ept_ad_enabled()) {
+            userError("X86 HarvestStatusBits: EPT accessed and dirty flags are not supported.");
+            current_syscall_error.type = seL4_IllegalOperation;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        root = (void *)cap_ept_pml4_cap_get_capPML4BasePtr(cap);
+        if (!cap_ept_pml4_cap_get_capPML4IsMapped(cap) ||
+                findEPTForASID(cap_ept_pml4_cap_get_capPML4MappedASID(cap)).ept != root) {
+            userError("X86 HarvestStatusBits: EPT PML4 is not assigned to an ASID.");
+            current_syscall_error.type = seL4_InvalidCapability;
+            current_syscall_error.invalidCapNumber = 0;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        top = BIT(EPT_PML4_INDEX_OFFSET + EPT_PML4_INDEX_BITS);
+#else
+        fail("Invalid cap type");
+#endif
+    }
+
+    if (length < 3 || excaps.excaprefs[0] == NULL) {
+        userError("X86 HarvestStatusBits: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    vaddr = getSyscallArg(0, buffer);
+    pages = getSyscallArg(1, buffer);
+    flags = getSyscallArg(2, buffer) & MASK(X86_STATUS_RESUME_SHIFT);
+    next = getSyscallArg(2, buffer) >> X86_STATUS_RESUME_SHIFT;
+    frameCap = excaps.excaprefs[0]->cap;
+
+    if (!IS_ALIGNED(vaddr, seL4_PageBits)) {
+        current_syscall_error.type = seL4_AlignmentError;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (vaddr >= top) {
+        userError("X86 HarvestStatusBits: Address is outside the address space.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (flags == 0 || (flags & ~(X86_STATUS_ACCESSED | X86_STATUS_DIRTY))) {
+        userError("X86 HarvestStatusBits: Invalid status bits %lx.", (unsigned long)flags);
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 2;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (!Arch_isUserAccessibleFrame(frameCap, true)) {
+        userError("X86 HarvestStatusBits: Invalid bitmap frame.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (pages > (top - vaddr) >> seL4_PageBits ||
+            pages > BIT(cap_get_capSizeBits(frameCap) + 3)) {
+        userError("X86 HarvestStatusBits: Range is outside the address space or the bitmap.");
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = MIN((top - vaddr) >> seL4_PageBits,
+                                                  BIT(cap_get_capSizeBits(frameCap) + 3));
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (next > pages) {
+        userError("X86 HarvestStatusBits: Resume point is past the end of the range.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 2;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    bitmap = (word_t *)cap_get_capPtr(frameCap);
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+
+#ifdef CONFIG_VTX
+    if (cap_get_capType(cap) == cap_ept_pml4_cap) {
+        eptEnableAccessedDirty(cap_ept_pml4_cap_get_capPML4MappedASID(cap));
+    }
+#endif
+
+    return performX86HarvestStatusBits(cap, root, vaddr, pages, flags, bitmap, next);
+}
+
 exception_t
 decodeX86ModeMMUInvocation(
     word_t label,
@@ -1413,8 +1685,7 @@ decodeX86ModeMMUInvocation(
     switch (cap_get_capType(cap)) {
 
     case cap_pml4_cap:
-        current_syscall_error.type = seL4_IllegalOperation;
-        return EXCEPTION_SYSCALL_ERROR;
+        return decodeX86HarvestStatusBits(label, length, cap, extraCaps, buffer);
 
     case cap_pdpt_cap:
         return decodeX64PDPTInvocation(label, length, cte, cap, extraCaps, buffer);
@@ -237,6 +237,40 @@ init_freemem(p_region_t ui_p_reg, mem_p_regs_t mem_p_regs)
     }
 }
 
+/* Provide unmapped frame caps covering a boot module, using large pages
+ * wherever a whole large page fits */
+BOOT_CODE static create_frames_of_region_ret_t
+create_module_frames(cap_t root_cnode_cap, p_region_t p_reg)
+{
+    region_t     reg = paddr_to_pptr_reg(p_reg);
+    pptr_t       f;
+    cap_t        frame_cap;
+    seL4_SlotPos slot_pos_before;
+    seL4_SlotPos slot_pos_after;
+
+    slot_pos_before = ndks_boot.slot_pos_cur;
+
+    for (f = reg.start; f < reg.end;) {
+        if (IS_ALIGNED(f, seL4_LargePageBits) && f + BIT(seL4_LargePageBits) <= reg.end) {
+            frame_cap = create_unmapped_it_frame_cap(f, true);
+            f += BIT(seL4_LargePageBits);
+        } else {
+            frame_cap = create_unmapped_it_frame_cap(f, false);
+            f += BIT(PAGE_BITS);
+        }
+        if (!provide_cap(root_cnode_cap, frame_cap))
+            return (create_frames_of_region_ret_t) {
+            S_REG_EMPTY, false
+        };
+    }
+
+    slot_pos_after = ndks_boot.slot_pos_cur;
+
+    return (create_frames_of_region_ret_t) {
+        (seL4_SlotRegion) { slot_pos_before, slot_pos_after }, true
+    };
+}
+
 /* This function initialises a node's kernel state. It does NOT initialise the CPU. */
 
 BOOT_CODE bool_t
@@ -250,7 +284,10 @@ init_sys_state(
     paddr_t*      drhu_list,
     acpi_rmrr_list_t *rmrr_list,
     seL4_X86_BootInfo_VBE *vbe,
-    seL4_X86_BootInfo_mmap_t *mb_mmap
+    seL4_X86_BootInfo_mmap_t *mb_mmap,
+    acpi_numa_info_t *numa_info,
+    seL4_X86_BootInfo_NUMA *numa_bi,
+    seL4_X86_BootInfo_Modules *modules_bi
 )
 {
     cap_t         root_cnode_cap;
@@ -266,6 +303,8 @@ init_sys_state(
     pptr_t        extra_bi_offset = 0;
     create_frames_of_region_ret_t create_frames_ret;
     create_frames_of_region_ret_t extra_bi_ret;
+    seL4_X86_BootInfo_Modules *extra_bi_modules = NULL;
+    word_t        i;
 
     /* convert from physical addresses to kernel pptrs */
     region_t ui_reg             = paddr_to_pptr_reg(ui_info.p_reg);
@@ -288,12 +327,28 @@ init_sys_state(
     word_t mb_mmap_size = sizeof(seL4_X86_BootInfo_mmap_t);
     extra_bi_size += mb_mmap_size;
 
+    extra_bi_size += sizeof(seL4_X86_BootInfo_NUMA);
+
+    if (modules_bi->numModules > 0) {
+        extra_bi_size += sizeof(seL4_X86_BootInfo_Modules);
+    }
+
+    word_t untyped_bi_size = calculate_untyped_bi_size();
+    extra_bi_size += untyped_bi_size;
+
     /* The region of the initial thread is the user image + ipcbuf and boot info */
     it_v_reg.start = ui_v_reg.start;
-    it_v_reg.end = ROUND_UP(extra_bi_frame_vptr + extra_bi_size, PAGE_BITS);
+    it_v_reg.end = extra_bi_frame_vptr + BIT(calculate_extra_bi_size_bits(extra_bi_size));
 
     init_freemem(ui_info.p_reg, mem_p_regs);
 
+    /* record the NUMA node of each memory range so untypeds never span nodes */
+    for (i = 0; i < numa_info->num_mem && i < MAX_NUM_NUMA_REG; i++) {
+        ndks_boot.numa_p_regs[i].p_reg = numa_info->mem[i].p_reg;
+        ndks_boot.numa_p_regs[i].node = numa_info->mem[i].node;
+    }
+    ndks_boot.num_numa_p_regs = MIN(numa_info->num_mem, MAX_NUM_NUMA_REG);
+
     /* create the root cnode */
     root_cnode_cap = create_root_cnode();
 
@@ -343,6 +398,27 @@ init_sys_state(
     memcpy((void*)(extra_bi_region.start + extra_bi_offset), mb_mmap, mb_mmap_size);
     extra_bi_offset += mb_mmap_size;
 
+    /* populate NUMA topology block */
+    numa_bi->header.id = SEL4_BOOTINFO_HEADER_X86_NUMA;
+    numa_bi->header.len = sizeof(seL4_X86_BootInfo_NUMA);
+    memcpy((void*)(extra_bi_region.start + extra_bi_offset), numa_bi, sizeof(seL4_X86_BootInfo_NUMA));
+    extra_bi_offset += sizeof(seL4_X86_BootInfo_NUMA);
+
+    /* populate boot modules block, the frames are filled in once they exist */
+    if (modules_bi->numModules > 0) {
+        modules_bi->header.id = SEL4_BOOTINFO_HEADER_X86_MODULES;
+        modules_bi->header.len = sizeof(seL4_X86_BootInfo_Modules);
+        extra_bi_modules = (seL4_X86_BootInfo_Modules*)(extra_bi_region.start + extra_bi_offset);
+        memcpy(extra_bi_modules, modules_bi, sizeof(seL4_X86_BootInfo_Modules));
+        extra_bi_offset += sizeof(seL4_X86_BootInfo_Modules);
+    }
+
+    /* populate untyped descriptor overflow block */
+    if (untyped_bi_size != 0) {
+        populate_untyped_bi(extra_bi_region.start + extra_bi_offset, untyped_bi_size);
+        extra_bi_offset += untyped_bi_size;
+    }
+
     /* provde a chunk for any leftover padding in the extended boot info */
     seL4_BootInfoHeader padding_header;
     padding_header.id = SEL4_BOOTINFO_HEADER_PADDING;
@@ -398,6 +474,18 @@ init_sys_state(
     }
     ndks_boot.bi_frame->userImageFrames = create_frames_ret.region;
 
+    /* create frames for the boot modules left in place */
+    for (i = 0; i < modules_bi->numModules; i++) {
+        create_frames_ret = create_module_frames(root_cnode_cap, (p_region_t) {
+            modules_bi->modules[i].paddr,
+            ROUND_UP(modules_bi->modules[i].paddr + modules_bi->modules[i].size, PAGE_BITS)
+        });
+        if (!create_frames_ret.success) {
+            return false;
+        }
+        extra_bi_modules->modules[i].frames = create_frames_ret.region;
+    }
+
     /* create the initial thread's ASID pool */
     it_ap_cap = create_it_asid_pool(root_cnode_cap);
     if (cap_get_capType(it_ap_cap) == cap_null_cap) {
@@ -19,6 +19,7 @@
 #include <arch/kernel/smp_sys.h>
 #include <arch/kernel/vspace.h>
 #include <arch/kernel/elf.h>
+#include <arch/kernel/lz4.h>
 #include <smp/lock.h>
 #include <arch/linker.h>
 #include <plat/machine/acpi.h>
@@ -67,8 +68,13 @@ typedef struct boot_state {
     mem_p_regs_t mem_p_regs;  /* physical memory regions */
     seL4_X86_BootInfo_VBE vbe_info; /* Potential VBE information from multiboot */
     seL4_X86_BootInfo_mmap_t mb_mmap_info; /* memory map information from multiboot */
+    acpi_numa_info_t numa_info; /* NUMA topology from the ACPI SRAT/SLIT */
+    seL4_X86_BootInfo_NUMA numa_bi; /* NUMA topology as handed to the root task */
+    seL4_X86_BootInfo_Modules modules_bi; /* boot modules left in place for the root task */
 } boot_state_t;
 
+compile_assert(numa_bi_cpus_sane, CONFIG_MAX_NUM_NODES <= SEL4_X86_MAX_NUMA_CPUS)
+
 BOOT_BSS
 boot_state_t boot_state;
 
@@ -119,6 +125,32 @@ load_boot_module(multiboot_module_t* boot_module, paddr_t load_paddr)
     word_t entry;
     Elf_Header_t* elf_file = (Elf_Header_t*)(word_t)boot_module->start;
 
+#ifdef CONFIG_BOOT_MODULE_LZ4
+    word_t module_size = boot_module->end - boot_module->start;
+    if (lz4_checkFrame(elf_file, module_size)) {
+        /* decompress the ELF file above the modules, the image itself is then
+         * loaded above the decompressed file */
+        uint64_t elf_size = lz4_getContentSize(elf_file, module_size);
+        paddr_t elf_paddr;
+        if (elf_size == 0) {
+            printf("Compressed boot module does not record its decompressed size\n");
+            return 0;
+        }
+        elf_paddr = find_load_paddr(load_paddr, elf_size);
+        if (!elf_paddr || !module_paddr_region_valid(elf_paddr, elf_paddr + elf_size)) {
+            printf("Not enough memory to decompress boot module\n");
+            return 0;
+        }
+        printf("decompressing %lu bytes to 0x%lx ", (word_t)elf_size, elf_paddr);
+        if (lz4_decompress(elf_file, module_size, (void*)elf_paddr, elf_size) != elf_size) {
+            printf("Boot module is not a valid LZ4 frame\n");
+            return 0;
+        }
+        elf_file = (Elf_Header_t*)elf_paddr;
+        load_paddr = ROUND_UP(elf_paddr + elf_size, PAGE_BITS);
+    }
+#endif
+
     if (!elf_checkFile(elf_file)) {
         printf("Boot module does not contain a valid ELF image\n");
         return 0;
@@ -176,16 +208,53 @@ load_boot_module(multiboot_module_t* boot_module, paddr_t load_paddr)
         return 0;
     }
 
-    /* initialise all initial userland memory and load potentially sparse ELF image */
-    memzero(
-        (void*)boot_state.ui_info.p_reg.start,
-        boot_state.ui_info.p_reg.end - boot_state.ui_info.p_reg.start
-    );
-    elf_load(elf_file, boot_state.ui_info.pv_offset);
+    /* load potentially sparse ELF image, zeroing only what the segments do not cover */
+    elf_load(elf_file, v_reg, boot_state.ui_info.pv_offset);
 
     return load_paddr;
 }
 
+/* Record all boot modules but the first for the root task, they are left in
+ * place and handed out as frames. Returns the end of the highest of them, or
+ * 0 if there are none */
+BOOT_CODE static paddr_t
+add_extra_boot_modules(multiboot_module_t* modules, word_t mod_count)
+{
+    paddr_t end = 0;
+    word_t i;
+    word_t j;
+    char *cmdline;
+    seL4_X86_BootModule_t *mod;
+
+    for (i = 1; i < mod_count; i++) {
+        if (boot_state.modules_bi.numModules == SEL4_X86_MAX_BOOT_MODULES) {
+            printf("Ignoring boot modules after #%ld, can only provide %d\n", i - 1, SEL4_X86_MAX_BOOT_MODULES);
+            break;
+        }
+        if (!IS_ALIGNED(modules[i].start, PAGE_BITS) ||
+                !module_paddr_region_valid(modules[i].start, modules[i].end)) {
+            printf("Ignoring boot module #%ld, it is not page aligned or not in usable memory\n", i);
+            continue;
+        }
+
+        mod = &boot_state.modules_bi.modules[boot_state.modules_bi.numModules];
+        mod->paddr = modules[i].start;
+        mod->size = modules[i].end - modules[i].start;
+        cmdline = (char*)(word_t)modules[i].name;
+        for (j = 0; cmdline && cmdline[j] && j < SEL4_X86_BOOT_MODULE_CMDLINE_LEN - 1; j++) {
+            mod->cmdline[j] = cmdline[j];
+        }
+        mod->cmdline[j] = 0;
+        boot_state.modules_bi.numModules++;
+
+        if (end < ROUND_UP(modules[i].end, PAGE_BITS)) {
+            end = ROUND_UP(modules[i].end, PAGE_BITS);
+        }
+    }
+
+    return end;
+}
+
 static BOOT_CODE bool_t
 try_boot_sys_node(cpu_id_t cpu_id)
 {
@@ -224,7 +293,10 @@ try_boot_sys_node(cpu_id_t cpu_id)
                 boot_state.drhu_list,
                 &boot_state.rmrr_list,
                 &boot_state.vbe_info,
-                &boot_state.mb_mmap_info
+                &boot_state.mb_mmap_info,
+                &boot_state.numa_info,
+                &boot_state.numa_bi,
+                &boot_state.modules_bi
             )) {
         return false;
     }
@@ -386,6 +458,7 @@ try_boot_sys(
 
     acpi_rsdt_t* acpi_rsdt; /* physical address of ACPI root */
     paddr_t mods_end_paddr; /* physical address where boot modules end */
+    paddr_t extra_mods_end_paddr; /* physical address where the modules left in place end */
     paddr_t load_paddr;
     word_t i;
     p_region_t ui_p_regs;
@@ -517,6 +590,15 @@ try_boot_sys(
         return false;
     }
 
+    /* query the NUMA topology from ACPI, this never fails as a machine without
+     * an SRAT is simply treated as a single node */
+    acpi_srat_scan(acpi_rsdt, &boot_state.numa_info);
+    boot_state.numa_bi.numNodes = boot_state.numa_info.num_nodes;
+    for (i = 0; i < boot_state.num_cpus; i++) {
+        boot_state.numa_bi.cpuNode[i] = acpi_numa_cpu_node(&boot_state.numa_info, boot_state.cpus[i]);
+    }
+    memcpy(boot_state.numa_bi.distance, boot_state.numa_info.distance, sizeof(boot_state.numa_bi.distance));
+
     if (config_set(CONFIG_IRQ_IOAPIC)) {
         if (boot_state.num_ioapic == 0) {
             printf("No IOAPICs detected\n");
@@ -562,6 +644,10 @@ try_boot_sys(
     mods_end_paddr = ROUND_UP(mods_end_paddr, PAGE_BITS);
     assert(mods_end_paddr > boot_state.ki_p_reg.end);
 
+    /* the remaining modules stay where they are, so the image must be moved
+     * above them. Record them before loading can overwrite their names */
+    extra_mods_end_paddr = add_extra_boot_modules(modules, mbi->part1.mod_count);
+
     printf("ELF-loading userland images from boot modules:\n");
     load_paddr = mods_end_paddr;
 
@@ -570,22 +656,23 @@ try_boot_sys(
         return false;
     }
 
-    /* calculate final location of userland images */
-    ui_p_regs.start = boot_state.ki_p_reg.end;
-    ui_p_regs.end = ui_p_regs.start + load_paddr - mods_end_paddr;
+    /* calculate final location of userland images. The image does not
+     * necessarily start at mods_end_paddr, e.g. when a compressed module was
+     * decompressed below it, so only the image itself is moved */
+    ui_p_regs.start = MAX(boot_state.ki_p_reg.end, extra_mods_end_paddr);
+    ui_p_regs.end = ui_p_regs.start + boot_state.ui_info.p_reg.end - boot_state.ui_info.p_reg.start;
 
     printf(
         "Moving loaded userland images to final location: from=0x%lx to=0x%lx size=0x%lx\n",
-        mods_end_paddr,
+        boot_state.ui_info.p_reg.start,
         ui_p_regs.start,
         ui_p_regs.end - ui_p_regs.start
     );
-    memcpy((void*)ui_p_regs.start, (void*)mods_end_paddr, ui_p_regs.end - ui_p_regs.start);
+    memcpy((void*)ui_p_regs.start, (void*)boot_state.ui_info.p_reg.start, ui_p_regs.end - ui_p_regs.start);
 
     /* adjust p_reg and pv_offset to final load address */
-    boot_state.ui_info.p_reg.start -= mods_end_paddr - ui_p_regs.start;
-    boot_state.ui_info.p_reg.end   -= mods_end_paddr - ui_p_regs.start;
-    boot_state.ui_info.pv_offset   -= mods_end_paddr - ui_p_regs.start;
+    boot_state.ui_info.pv_offset   -= boot_state.ui_info.p_reg.start - ui_p_regs.start;
+    boot_state.ui_info.p_reg        = ui_p_regs;
 
     /* ==== following code corresponds to abstract specification after "select" ==== */
 
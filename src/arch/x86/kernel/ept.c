@@ -16,7 +16,9 @@
 
 #include <model/statedata.h>
 #include <arch/kernel/ept.h>
+#include <mode/kernel/vspace.h>
 #include <arch/api/invocation.h>
+#include <model/preemption.h>
 
 struct lookupEPTPDPTSlot_ret {
     exception_t status;
@@ -88,11 +90,13 @@ findEPTForASID(asid_t asid)
         current_lookup_fault = lookup_fault_invalid_root_new();
 
         ret.ept = NULL;
+        ret.accessedDirty = false;
         ret.status = EXCEPTION_LOOKUP_FAULT;
         return ret;
     }
 
     ret.ept = (ept_pml4e_t*)asid_map_asid_map_ept_get_ept_root(asid_map);
+    ret.accessedDirty = asid_map_asid_map_ept_get_accessed_dirty(asid_map);
     ret.status = EXCEPTION_NONE;
     return ret;
 }
@@ -381,29 +385,79 @@ decodeX86EPTPDPTInvocation(
     return performEPTPDPTInvocationMap(cap, cte, pml4e, pml4Slot, pml4);
 }
 
-exception_t
-decodeX86EPTInvocation(
-    word_t invLabel,
-    word_t length,
-    cptr_t cptr,
-    cte_t* cte,
-    cap_t cap,
-    extra_caps_t excaps,
-    word_t* buffer
-)
+/* EPT accessed and dirty flags, at the same position in both page sizes */
+#define EPT_ACCESSED    BIT(8)
+#define EPT_DIRTY       BIT(9)
+
+static inline word_t
+eptPagesToBoundary(vptr_t vaddr, word_t bits)
 {
-    switch (cap_get_capType(cap)) {
-    case cap_ept_pdpt_cap:
-        return decodeX86EPTPDPTInvocation(invLabel, length, cte, cap, excaps, buffer);
-    case cap_ept_pd_cap:
-        return decodeX86EPTPDInvocation(invLabel, length, cte, cap, excaps, buffer);
-    case cap_ept_pt_cap:
-        return decodeX86EPTPTInvocation(invLabel, length, cte, cap, excaps, buffer);
-    default:
-        fail("Invalid cap type");
+    return (BIT(bits) - (vaddr & MASK(bits))) >> seL4_PageBits;
+}
+
+/* Accessed and dirty flags make the processor treat guest paging-structure
+ * reads as writes, so they are only turned on for EPTs that are harvested.
+ * Entries written before have both flags clear. VCPUs using the EPT load
+ * the new EPTP on their next VM entry. */
+void
+eptEnableAccessedDirty(asid_t asid)
+{
+    asid_pool_t *poolPtr = x86KSASIDTable[asid >> asidLowBits];
+    asid_map_t *asid_map;
+
+    assert(poolPtr != NULL);
+    asid_map = &poolPtr->array[asid & MASK(asidLowBits)];
+    assert(asid_map_get_type(*asid_map) == asid_map_asid_map_ept);
+
+    if (!asid_map_asid_map_ept_get_accessed_dirty(*asid_map)) {
+        *asid_map = asid_map_asid_map_ept_set_accessed_dirty(*asid_map, 1);
+        /* cached translations would never set the flags */
+        invept((ept_pml4e_t *)asid_map_asid_map_ept_get_ept_root(*asid_map));
     }
 }
 
+harvestStatus_ret_t
+eptHarvestStatusBits(ept_pml4e_t *pml4, vptr_t vaddr, word_t flags)
+{
+    harvestStatus_ret_t ret;
+    lookupEPTPDSlot_ret_t pd_ret;
+    lookupEPTPTSlot_ret_t pt_ret;
+    word_t mask;
+
+    mask = ((flags & X86_STATUS_ACCESSED) ? EPT_ACCESSED : 0) |
+           ((flags & X86_STATUS_DIRTY) ? EPT_DIRTY : 0);
+    ret.mapped = false;
+    ret.set = false;
+
+    pd_ret = lookupEPTPDSlot(pml4, vaddr);
+    if (pd_ret.status != EXCEPTION_NONE) {
+        ret.pages = eptPagesToBoundary(vaddr, EPT_PDPT_INDEX_OFFSET);
+        return ret;
+    }
+
+    if (ept_pde_ptr_get_page_size(pd_ret.pdSlot) == ept_pde_ept_pde_2m) {
+        ret.pages = eptPagesToBoundary(vaddr, EPT_PD_INDEX_OFFSET);
+        if (ept_pde_ept_pde_2m_ptr_get_read(pd_ret.pdSlot)) {
+            ret.mapped = true;
+            ret.set = testAndClearEntryBits(&pd_ret.pdSlot->words[0], mask);
+        }
+        return ret;
+    }
+
+    pt_ret = lookupEPTPTSlot(pml4, vaddr);
+    if (pt_ret.status != EXCEPTION_NONE) {
+        ret.pages = eptPagesToBoundary(vaddr, EPT_PD_INDEX_OFFSET);
+        return ret;
+    }
+
+    ret.pages = 1;
+    if (ept_pte_ptr_get_read(pt_ret.ptSlot)) {
+        ret.mapped = true;
+        ret.set = testAndClearEntryBits(&pt_ret.ptSlot->words[0], mask);
+    }
+    return ret;
+}
+
 EPTPageDirectoryMapped_ret_t
 EPTPageDirectoryMapped(asid_t asid, vptr_t vaddr, ept_pde_t *pd)
 {
@@ -996,50 +1050,46 @@ decodeX86EPTPageMap(
     }
 }
 
-void
-unmapEPTPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, void *pptr)
+/* Clears the entry mapping the frame at pptr, if it is still mapped at vptr,
+ * and returns whether it was. The caller must invalidate the EPT. */
+static bool_t
+clearEPTPageEntry(vm_page_size_t page_size, ept_pml4e_t *pml4, vptr_t vptr, void *pptr)
 {
-    findEPTForASID_ret_t find_ret;
     paddr_t addr = addrFromPPtr(pptr);
 
-    find_ret = findEPTForASID(asid);
-    if (find_ret.status != EXCEPTION_NONE) {
-        return;
-    }
-
     switch (page_size) {
     case X86_SmallPage: {
         lookupEPTPTSlot_ret_t lu_ret;
 
-        lu_ret = lookupEPTPTSlot(find_ret.ept, vptr);
+        lu_ret = lookupEPTPTSlot(pml4, vptr);
         if (lu_ret.status != EXCEPTION_NONE) {
-            return;
+            return false;
         }
         if (!ept_pte_ptr_get_read(lu_ret.ptSlot)) {
-            return;
+            return false;
         }
         if (ept_pte_ptr_get_page_base_address(lu_ret.ptSlot) != addr) {
-            return;
+            return false;
         }
 
         *lu_ret.ptSlot = ept_pte_new(0, 0, 0, 0, 0, 0, 0);
-        break;
+        return true;
     }
     case X86_LargePage: {
         lookupEPTPDSlot_ret_t lu_ret;
 
-        lu_ret = lookupEPTPDSlot(find_ret.ept, vptr);
+        lu_ret = lookupEPTPDSlot(pml4, vptr);
         if (lu_ret.status != EXCEPTION_NONE) {
-            return;
+            return false;
         }
         if (ept_pde_ptr_get_page_size(lu_ret.pdSlot) != ept_pde_ept_pde_2m) {
-            return;
+            return false;
         }
         if (!ept_pde_ept_pde_2m_ptr_get_read(lu_ret.pdSlot)) {
-            return;
+            return false;
         }
         if (ept_pde_ept_pde_2m_ptr_get_page_base_address(lu_ret.pdSlot) != addr) {
-            return;
+            return false;
         }
 
         lu_ret.pdSlot[0] = ept_pde_ept_pde_2m_new(0, 0, 0, 0, 0, 0, 0);
@@ -1051,13 +1101,335 @@ unmapEPTPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, void *pptr)
 
             lu_ret.pdSlot[1] = ept_pde_ept_pde_2m_new(0, 0, 0, 0, 0, 0, 0);
         }
-        break;
+        return true;
     }
     default:
         /* we did not allow mapping additional page sizes into EPT objects,
          * so this should not happen. As we have no way to return an error
          * all we can do is assert */
         assert(!"Invalid page size for unmap");
+        return false;
+    }
+}
+
+void
+unmapEPTPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, void *pptr)
+{
+    findEPTForASID_ret_t find_ret;
+
+    find_ret = findEPTForASID(asid);
+    if (find_ret.status != EXCEPTION_NONE) {
+        return;
+    }
+
+    if (clearEPTPageEntry(page_size, find_ret.ept, vptr, pptr)) {
+        invept(find_ret.ept);
+    }
+}
+
+static exception_t
+mapEPTRangeFrame(cte_t *cte, ept_pml4e_t *pml4, asid_t asid, vptr_t gpa,
+                 word_t w_rightsMask, vm_attributes_t vmAttr)
+{
+    cap_t cap;
+    paddr_t paddr;
+    vm_rights_t vmRights;
+    vm_page_size_t frameSize;
+
+    cap = cte->cap;
+    frameSize = cap_frame_cap_get_capFSize(cap);
+    vmRights = maskVMRights(cap_frame_cap_get_capFVMRights(cap), rightsFromWord(w_rightsMask));
+    paddr = pptr_to_paddr((void*)cap_frame_cap_get_capFBasePtr(cap));
+
+    if (!checkVPAlignment(frameSize, gpa)) {
+        userError("X86EPTPML4MapRange: Frame at %p is not aligned.", (void*)gpa);
+        current_syscall_error.type = seL4_AlignmentError;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (gpa >= BIT(EPT_PML4_INDEX_OFFSET + EPT_PML4_INDEX_BITS)) {
+        userError("X86EPTPML4MapRange: Range is outside the guest physical address space.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    switch (frameSize) {
+    case X86_SmallPage: {
+        lookupEPTPTSlot_ret_t lu_ret;
+
+        lu_ret = lookupEPTPTSlot(pml4, gpa);
+        if (lu_ret.status != EXCEPTION_NONE) {
+            userError("X86EPTPML4MapRange: Need a page table at %p.", (void*)gpa);
+            current_syscall_error.type = seL4_FailedLookup;
+            current_syscall_error.failedLookupWasSource = false;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        if (ept_pte_ptr_get_read(lu_ret.ptSlot)) {
+            userError("X86EPTPML4MapRange: Mapping already present at %p.", (void*)gpa);
+            current_syscall_error.type = seL4_DeleteFirst;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        *lu_ret.ptSlot = ept_pte_new(
+                             paddr,
+                             0,
+                             0,
+                             eptCacheFromVmAttr(vmAttr),
+                             1,
+                             WritableFromVMRights(vmRights),
+                             1);
+        break;
+    }
+
+    case X86_LargePage: {
+        lookupEPTPDSlot_ret_t lu_ret;
+        word_t i;
+
+        lu_ret = lookupEPTPDSlot(pml4, gpa);
+        if (lu_ret.status != EXCEPTION_NONE) {
+            userError("X86EPTPML4MapRange: Need a page directory at %p.", (void*)gpa);
+            current_syscall_error.type = seL4_FailedLookup;
+            current_syscall_error.failedLookupWasSource = false;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        /* a large frame takes two entries when it is larger than 2M */
+        for (i = 0; i < BIT(LARGE_PAGE_BITS - EPT_PD_INDEX_OFFSET); i++) {
+            if (((ept_pde_ptr_get_page_size(lu_ret.pdSlot + i) == ept_pde_ept_pde_4k) &&
+                    ept_pde_ept_pde_4k_ptr_get_read(lu_ret.pdSlot + i)) ||
+                    ((ept_pde_ptr_get_page_size(lu_ret.pdSlot + i) == ept_pde_ept_pde_2m) &&
+                     ept_pde_ept_pde_2m_ptr_get_read(lu_ret.pdSlot + i))) {
+                userError("X86EPTPML4MapRange: Mapping already present at %p.", (void*)gpa);
+                current_syscall_error.type = seL4_DeleteFirst;
+                return EXCEPTION_SYSCALL_ERROR;
+            }
+        }
+        for (i = 0; i < BIT(LARGE_PAGE_BITS - EPT_PD_INDEX_OFFSET); i++) {
+            lu_ret.pdSlot[i] = ept_pde_ept_pde_2m_new(
+                                   paddr + i * BIT(EPT_PD_INDEX_OFFSET),
+                                   0,
+                                   0,
+                                   eptCacheFromVmAttr(vmAttr),
+                                   1,
+                                   WritableFromVMRights(vmRights),
+                                   1);
+        }
+        break;
+    }
+
+    default:
+        userError("X86EPTPML4MapRange: Attempted to map unsupported page size.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    cap = cap_frame_cap_set_capFMappedASID(cap, asid);
+    cap = cap_frame_cap_set_capFMappedAddress(cap, gpa);
+    cap = cap_frame_cap_set_capFMapType(cap, X86_MappingEPT);
+    cte->cap = cap;
+
+    return EXCEPTION_NONE;
+}
+
+/* A preempted range invocation rewrites its arguments in the caller's message
+ * registers to describe what is left, so the restarted invocation continues
+ * with the next slot */
+static exception_t
+performEPTRangeInvocation(word_t invLabel, ept_pml4e_t *pml4, asid_t asid,
+                          cte_t *window, word_t first, word_t count, vptr_t gpa,
+                          word_t rights, word_t attr, word_t *buffer)
+{
+    cte_t *cte;
+    cap_t cap;
+    word_t i;
+    bool_t changed;
+    exception_t status;
+
+    changed = false;
+    status = EXCEPTION_NONE;
+    for (i = 0; i < count;) {
+        cte = window + i;
+        cap = cte->cap;
+
+        if (invLabel == X86EPTPML4MapRange) {
+            if (cap_get_capType(cap) != cap_frame_cap ||
+                    cap_frame_cap_get_capFMappedASID(cap) != asidInvalid) {
+                userError("X86EPTPML4MapRange: Slot %lu does not hold an unmapped frame.",
+                          (unsigned long)(first + i));
+                current_syscall_error.type = seL4_InvalidCapability;
+                current_syscall_error.invalidCapNumber = 1;
+                status = EXCEPTION_SYSCALL_ERROR;
+                break;
+            }
+            status = mapEPTRangeFrame(cte, pml4, asid, gpa, rights, vmAttributesFromWord(attr));
+            if (status != EXCEPTION_NONE) {
+                break;
+            }
+            /* only non-present entries were written, and those are never
+             * cached, so a map needs no invalidation */
+            gpa += BIT(pageBitsForSize(cap_frame_cap_get_capFSize(cap)));
+        } else if (cap_get_capType(cap) == cap_frame_cap &&
+                   cap_frame_cap_get_capFMapType(cap) == X86_MappingEPT &&
+                   cap_frame_cap_get_capFMappedASID(cap) == asid) {
+            changed |= clearEPTPageEntry(cap_frame_cap_get_capFSize(cap), pml4,
+                                         cap_frame_cap_get_capFMappedAddress(cap),
+                                         (void *)cap_frame_cap_get_capFBasePtr(cap));
+            cap_frame_cap_ptr_set_capFMappedAddress(&cte->cap, 0);
+            cap_frame_cap_ptr_set_capFMappedASID(&cte->cap, asidInvalid);
+            cap_frame_cap_ptr_set_capFMapType(&cte->cap, X86_MappingNone);
+        }
+        i++;
+
+        status = preemptionPoint();
+        if (unlikely(status != EXCEPTION_NONE)) {
+            if (invLabel == X86EPTPML4MapRange) {
+                setSyscallArg(0, buffer, gpa);
+                setSyscallArg(1, buffer, first + i);
+                setSyscallArg(2, buffer, count - i);
+            } else {
+                setSyscallArg(0, buffer, first + i);
+                setSyscallArg(1, buffer, count - i);
+            }
+            break;
+        }
+    }
+
+    /* one invalidation for everything unmapped in this batch, including the
+     * part done before an error or preemption */
+    if (changed) {
+        invept(pml4);
+    }
+
+    return status;
+}
+
+static exception_t
+decodeX86EPTRangeInvocation(word_t invLabel, word_t length, cap_t cap,
+                            extra_caps_t excaps, word_t *buffer)
+{
+    cap_t cnodeCap;
+    cte_t *window;
+    ept_pml4e_t *pml4;
+    asid_t asid;
+    vptr_t gpa;
+    word_t first, count, rights, attr, radix;
+    findEPTForASID_ret_t find_ret;
+
+    gpa = 0;
+    rights = 0;
+    attr = 0;
+
+    if (invLabel == X86EPTPML4MapRange) {
+        if (length < 5 || excaps.excaprefs[0] == NULL) {
+            userError("X86EPTPML4MapRange: Truncated message.");
+            current_syscall_error.type = seL4_TruncatedMessage;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        gpa = getSyscallArg(0, buffer);
+        first = getSyscallArg(1, buffer);
+        count = getSyscallArg(2, buffer);
+        rights = getSyscallArg(3, buffer);
+        attr = getSyscallArg(4, buffer);
+
+        if (!IS_ALIGNED(gpa, seL4_PageBits)) {
+            current_syscall_error.type = seL4_AlignmentError;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+    } else {
+        if (length < 2 || excaps.excaprefs[0] == NULL) {
+            userError("X86EPTPML4UnmapRange: Truncated message.");
+            current_syscall_error.type = seL4_TruncatedMessage;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        first = getSyscallArg(0, buffer);
+        count = getSyscallArg(1, buffer);
+    }
+
+    if (!cap_ept_pml4_cap_get_capPML4IsMapped(cap)) {
+        userError("X86EPTPML4 Map/UnmapRange: EPT PML4 is not assigned to an ASID.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+    pml4 = (ept_pml4e_t*)cap_ept_pml4_cap_get_capPML4BasePtr(cap);
+    asid = cap_ept_pml4_cap_get_capPML4MappedASID(cap);
+
+    find_ret = findEPTForASID(asid);
+    if (find_ret.status != EXCEPTION_NONE || find_ret.ept != pml4) {
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    cnodeCap = excaps.excaprefs[0]->cap;
+    if (cap_get_capType(cnodeCap) != cap_cnode_cap) {
+        userError("X86EPTPML4 Map/UnmapRange: Window is not in a CNode.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    radix = cap_cnode_cap_get_capCNodeRadix(cnodeCap);
+    if (first >= BIT(radix) || count > BIT(radix) - first) {
+        userError("X86EPTPML4 Map/UnmapRange: Window is not within the CNode.");
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = BIT(radix);
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+    window = CTE_PTR(cap_cnode_cap_get_capCNodePtr(cnodeCap)) + first;
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+
+    return performEPTRangeInvocation(invLabel, pml4, asid, window, first, count,
+                                     gpa, rights, attr, buffer);
+}
+
+static exception_t
+decodeX86EPTPML4Invocation(word_t invLabel, word_t length, cap_t cap,
+                           extra_caps_t excaps, word_t *buffer)
+{
+    switch (invLabel) {
+    case X86EPTPML4MapRange:
+    case X86EPTPML4UnmapRange:
+        return decodeX86EPTRangeInvocation(invLabel, length, cap, excaps, buffer);
+
+#ifdef CONFIG_ARCH_X86_64
+    case X86EPTPML4HarvestStatusBits:
+        return decodeX86HarvestStatusBits(invLabel, length, cap, excaps, buffer);
+#endif
+
+    default:
+        userError("X86EPTPML4: Illegal operation.");
+        current_syscall_error.type = seL4_IllegalOperation;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+}
+
+exception_t
+decodeX86EPTInvocation(
+    word_t invLabel,
+    word_t length,
+    cptr_t cptr,
+    cte_t* cte,
+    cap_t cap,
+    extra_caps_t excaps,
+    word_t* buffer
+)
+{
+    switch (cap_get_capType(cap)) {
+    case cap_ept_pml4_cap:
+        return decodeX86EPTPML4Invocation(invLabel, length, cap, excaps, buffer);
+    case cap_ept_pdpt_cap:
+        return decodeX86EPTPDPTInvocation(invLabel, length, cte, cap, excaps, buffer);
+    case cap_ept_pd_cap:
+        return decodeX86EPTPDInvocation(invLabel, length, cte, cap, excaps, buffer);
+    case cap_ept_pt_cap:
+        return decodeX86EPTPTInvocation(invLabel, length, cte, cap, excaps, buffer);
+    default:
+        fail("Invalid cap type");
     }
 }
 
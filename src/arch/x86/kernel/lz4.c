@@ -0,0 +1,206 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the GNU General Public License version 2. Note that NO WARRANTY is provided.
+ * See "LICENSE_GPLv2.txt" for details.
+ *
+ * @TAG(DATA61_GPL)
+ */
+
+#include <config.h>
+
+#ifdef CONFIG_BOOT_MODULE_LZ4
+
+#include <util.h>
+#include <arch/kernel/lz4.h>
+#include <arch/linker.h>
+
+#define LZ4_FRAME_MAGIC         0x184D2204
+#define LZ4_FLG_VERSION_MASK    0xc0
+#define LZ4_FLG_VERSION         0x40
+#define LZ4_FLG_BLOCK_CHECKSUM  BIT(4)
+#define LZ4_FLG_CONTENT_SIZE    BIT(3)
+#define LZ4_FLG_CONTENT_CHECKSUM BIT(2)
+#define LZ4_FLG_DICT_ID         BIT(0)
+#define LZ4_BLOCK_UNCOMPRESSED  BIT(31)
+#define LZ4_MIN_MATCH           4
+#define LZ4_LAST_LITERALS       5
+
+/* magic, FLG, BD and HC */
+#define LZ4_HEADER_MIN_SIZE     7
+
+BOOT_CODE static uint32_t
+lz4_read32(uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+BOOT_CODE static uint64_t
+lz4_read64(uint8_t *p)
+{
+    return lz4_read32(p) | ((uint64_t)lz4_read32(p + 4) << 32);
+}
+
+BOOT_CODE bool_t
+lz4_checkFrame(void *src, word_t src_len)
+{
+    uint8_t *p = src;
+
+    return src_len >= LZ4_HEADER_MIN_SIZE &&
+           lz4_read32(p) == LZ4_FRAME_MAGIC &&
+           (p[4] & LZ4_FLG_VERSION_MASK) == LZ4_FLG_VERSION;
+}
+
+/* Returns the decompressed size recorded in the frame header, or 0 if the
+ * frame was created without one (lz4 --content-size) */
+BOOT_CODE uint64_t
+lz4_getContentSize(void *src, word_t src_len)
+{
+    uint8_t *p = src;
+
+    if (!lz4_checkFrame(src, src_len) || !(p[4] & LZ4_FLG_CONTENT_SIZE) ||
+            src_len < LZ4_HEADER_MIN_SIZE + 8) {
+        return 0;
+    }
+    return lz4_read64(p + 6);
+}
+
+/* Reads an LZ4 length extension, returns false if it runs past end */
+BOOT_CODE static bool_t
+lz4_readLength(uint8_t **src, uint8_t *end, word_t *len)
+{
+    uint8_t b;
+
+    do {
+        if (*src >= end) {
+            return false;
+        }
+        b = *(*src)++;
+        *len += b;
+    } while (b == 255);
+    return true;
+}
+
+/* Decompresses one block into [dst_start + *pos, dst_start + dst_len). Matches
+ * may refer back into earlier blocks, as blocks are decoded contiguously */
+BOOT_CODE static bool_t
+lz4_decompressBlock(uint8_t *src, word_t src_len, uint8_t *dst_start, word_t dst_len, word_t *pos)
+{
+    uint8_t *end = src + src_len;
+    uint8_t *dst = dst_start + *pos;
+    uint8_t *dst_end = dst_start + dst_len;
+    uint8_t *match;
+    uint8_t token;
+    word_t len;
+    word_t offset;
+
+    while (src < end) {
+        token = *src++;
+
+        /* literals */
+        len = token >> 4;
+        if (len == 15 && !lz4_readLength(&src, end, &len)) {
+            return false;
+        }
+        if (len > (word_t)(end - src) || len > (word_t)(dst_end - dst)) {
+            return false;
+        }
+        memcpy(dst, src, len);
+        src += len;
+        dst += len;
+
+        /* the last sequence of a block has no match */
+        if (src == end) {
+            break;
+        }
+
+        /* match */
+        if (end - src < 2) {
+            return false;
+        }
+        offset = src[0] | (src[1] << 8);
+        src += 2;
+        if (offset == 0 || offset > (word_t)(dst - dst_start)) {
+            return false;
+        }
+        len = token & 0xf;
+        if (len == 15 && !lz4_readLength(&src, end, &len)) {
+            return false;
+        }
+        len += LZ4_MIN_MATCH;
+        if (len > (word_t)(dst_end - dst)) {
+            return false;
+        }
+        /* the match may overlap the output, so copy forwards byte by byte */
+        match = dst - offset;
+        while (len--) {
+            *dst++ = *match++;
+        }
+    }
+
+    *pos = dst - dst_start;
+    return true;
+}
+
+/* Decompresses an LZ4 frame into dst. Checksums are not verified. Returns the
+ * number of bytes written, or 0 if the frame is malformed or too large */
+BOOT_CODE word_t
+lz4_decompress(void *src, word_t src_len, void *dst, word_t dst_len)
+{
+    uint8_t *p = src;
+    uint8_t *end = p + src_len;
+    uint8_t flg;
+    uint32_t block;
+    word_t block_len;
+    word_t pos = 0;
+
+    if (!lz4_checkFrame(src, src_len)) {
+        return 0;
+    }
+    flg = p[4];
+    p += 7;
+    if (flg & LZ4_FLG_CONTENT_SIZE) {
+        p += 8;
+    }
+    if (flg & LZ4_FLG_DICT_ID) {
+        p += 4;
+    }
+    if (p > end) {
+        return 0;
+    }
+
+    while (true) {
+        if (end - p < 4) {
+            return 0;
+        }
+        block = lz4_read32(p);
+        p += 4;
+        if (block == 0) {
+            break;
+        }
+        block_len = block & ~LZ4_BLOCK_UNCOMPRESSED;
+        if (block_len > (word_t)(end - p)) {
+            return 0;
+        }
+        if (block & LZ4_BLOCK_UNCOMPRESSED) {
+            if (block_len > dst_len - pos) {
+                return 0;
+            }
+            memcpy((uint8_t *)dst + pos, p, block_len);
+            pos += block_len;
+        } else if (!lz4_decompressBlock(p, block_len, dst, dst_len, &pos)) {
+            return 0;
+        }
+        p += block_len;
+        if (flg & LZ4_FLG_BLOCK_CHECKSUM) {
+            p += 4;
+        }
+    }
+
+    return pos;
+}
+
+#endif /* CONFIG_BOOT_MODULE_LZ4 */
@@ -563,14 +563,96 @@ findVSpaceForASID_ret_t findVSpaceForASID(asid_t asid)
     return ret;
 }
 
+/* Page fault error code bits */
+#define PF_PRESENT      BIT(0)
+#define PF_WRITE        BIT(1)
+#define PF_USER         BIT(2)
+#define PF_INSTRUCTION  BIT(4)
+
+static bool_t
+accessPermitted(word_t present, word_t read_write, word_t super_user, word_t xd, word_t fault)
+{
+    if (!present) {
+        return false;
+    }
+    if ((fault & PF_WRITE) && !read_write) {
+        return false;
+    }
+    if ((fault & PF_USER) && !super_user) {
+        return false;
+    }
+    return !((fault & PF_INSTRUCTION) && xd);
+}
+
+/* A remap that only added rights does not shoot down the TLB, so a thread
+ * can fault on a stale, less permissive entry. The processor has already
+ * dropped that entry by the time we get here, so if the paging structures
+ * now allow the access we just let the thread retry it. */
+static bool_t
+isSpuriousVMFault(tcb_t *thread, vptr_t addr, word_t fault)
+{
+    cap_t threadRoot;
+    vspace_root_t *vspace;
+    lookupPDSlot_ret_t pdSlot;
+    lookupPTSlot_ret_t ptSlot;
+    pde_t pde;
+    pte_t pte;
+
+    if (!(fault & PF_PRESENT)) {
+        return false;
+    }
+
+    threadRoot = TCB_PTR_CTE_PTR(thread, tcbVTable)->cap;
+    if (!isValidNativeRoot(threadRoot)) {
+        return false;
+    }
+    vspace = (vspace_root_t*)pptr_of_cap(threadRoot);
+
+    pdSlot = lookupPDSlot(vspace, addr);
+    if (pdSlot.status != EXCEPTION_NONE) {
+        return false;
+    }
+    pde = *pdSlot.pdSlot;
+    if (pde_get_page_size(pde) == pde_pde_large) {
+        return accessPermitted(pde_pde_large_get_present(pde),
+                               pde_pde_large_get_read_write(pde),
+                               pde_pde_large_get_super_user(pde),
+#ifdef CONFIG_ARCH_X86_64
+                               pde_pde_large_get_xd(pde),
+#else
+                               0,
+#endif
+                               fault);
+    }
+
+    ptSlot = lookupPTSlot(vspace, addr);
+    if (ptSlot.status != EXCEPTION_NONE) {
+        return false;
+    }
+    pte = *ptSlot.ptSlot;
+    return accessPermitted(pte_get_present(pte),
+                           pte_get_read_write(pte),
+                           pte_get_super_user(pte),
+#ifdef CONFIG_ARCH_X86_64
+                           pte_get_xd(pte),
+#else
+                           0,
+#endif
+                           fault);
+}
+
 exception_t handleVMFault(tcb_t* thread, vm_fault_type_t vm_faultType)
 {
-    uint32_t addr;
+    word_t addr;
     uint32_t fault;
 
     addr = getFaultAddr();
     fault = getRegister(thread, Error);
 
+    if (isSpuriousVMFault(thread, addr, fault)) {
+        return EXCEPTION_NONE;
+    }
+
     switch (vm_faultType) {
     case seL4_DataFault:
         current_fault = seL4_Fault_VMFault_new(addr, fault, false);
@@ -810,21 +892,94 @@ performX86PageInvocationMapPDE(cap_t cap, cte_t *ctSlot, pde_t *pdSlot, pde_t pd
     return EXCEPTION_NONE;
 }
 
+/* A remap that keeps the frame and its attributes and only adds rights can
+ * leave stale entries in the TLB: any access they deny faults, the processor
+ * drops the entry, and handleVMFault lets the thread retry. */
+static bool_t
+isPTEPermissionUpgrade(pte_t old, pte_t new)
+{
+    if (!pte_get_present(old) ||
+            pte_get_read_write(new) < pte_get_read_write(old) ||
+            pte_get_super_user(new) < pte_get_super_user(old)) {
+        return false;
+    }
+    /* ignore the bits the hardware sets as the page is used */
+    old = pte_set_accessed(old, pte_get_accessed(new));
+    old = pte_set_dirty(old, pte_get_dirty(new));
+    old = pte_set_read_write(old, pte_get_read_write(new));
+    old = pte_set_super_user(old, pte_get_super_user(new));
+    return old.words[0] == new.words[0];
+}
+
+static bool_t
+isPDEPermissionUpgrade(pde_t old, pde_t new)
+{
+    if (pde_get_page_size(old) != pde_pde_large ||
+            !pde_pde_large_get_present(old) ||
+            pde_pde_large_get_read_write(new) < pde_pde_large_get_read_write(old) ||
+            pde_pde_large_get_super_user(new) < pde_pde_large_get_super_user(old)) {
+        return false;
+    }
+    old = pde_pde_large_set_accessed(old, pde_pde_large_get_accessed(new));
+    old = pde_pde_large_set_dirty(old, pde_pde_large_get_dirty(new));
+    old = pde_pde_large_set_read_write(old, pde_pde_large_get_read_write(new));
+    old = pde_pde_large_set_super_user(old, pde_pde_large_get_super_user(new));
+    return old.words[0] == new.words[0];
+}
+
+/* Without a flush, translations cached with the accessed or dirty bit set
+ * never set it again, so an upgrade keeps the bits of the old entry. The
+ * hardware may set them on another core while the entry is replaced, hence
+ * the compare and exchange. */
+static void
+storeUpgradedPTE(pte_t *ptSlot, pte_t pte)
+{
+    pte_t old = *ptSlot;
+    pte_t new;
+
+    do {
+        new = pte_set_accessed(pte, pte_get_accessed(old));
+        new = pte_set_dirty(new, pte_get_dirty(old));
+    } while (!__atomic_compare_exchange_n(&ptSlot->words[0], &old.words[0], new.words[0],
+                                          false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+static void
+storeUpgradedPDE(pde_t *pdSlot, pde_t pde)
+{
+    pde_t old = *pdSlot;
+    pde_t new;
+
+    do {
+        new = pde_pde_large_set_accessed(pde, pde_pde_large_get_accessed(old));
+        new = pde_pde_large_set_dirty(new, pde_pde_large_get_dirty(old));
+    } while (!__atomic_compare_exchange_n(&pdSlot->words[0], &old.words[0], new.words[0],
+                                          false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
 static exception_t
 performX86PageInvocationRemapPTE(pte_t *ptSlot, pte_t pte, asid_t asid, vspace_root_t *vspace)
 {
-    *ptSlot = pte;
-    invalidatePageStructureCacheASID(pptr_to_paddr(vspace), asid,
-                                     SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+    if (isPTEPermissionUpgrade(*ptSlot, pte)) {
+        storeUpgradedPTE(ptSlot, pte);
+    } else {
+        *ptSlot = pte;
+        invalidatePageStructureCacheASID(pptr_to_paddr(vspace), asid,
+                                         SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+    }
     return EXCEPTION_NONE;
 }
 
 static exception_t
 performX86PageInvocationRemapPDE(pde_t *pdSlot, pde_t pde, asid_t asid, vspace_root_t *vspace)
 {
-    *pdSlot = pde;
-    invalidatePageStructureCacheASID(pptr_to_paddr(vspace), asid,
-                                     SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+    if (isPDEPermissionUpgrade(*pdSlot, pde)) {
+        storeUpgradedPDE(pdSlot, pde);
+    } else {
+        *pdSlot = pde;
+        invalidatePageStructureCacheASID(pptr_to_paddr(vspace), asid,
+                                         SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+    }
     return EXCEPTION_NONE;
 }
 
@@ -845,6 +1000,112 @@ performX86PageInvocationUnmap(cap_t cap, cte_t *ctSlot)
     return EXCEPTION_NONE;
 }
 
+#ifdef CONFIG_FRAME_DONATION
+donateFrame_ret_t
+Arch_donateFrame(cap_t cap, tcb_t *receiver)
+{
+    donateFrame_ret_t       ret;
+    cap_t                   vspaceCap;
+    vspace_root_t*          vspace;
+    asid_t                  asid;
+    findVSpaceForASID_ret_t find_ret;
+    lookupPTSlot_ret_t      lu_ret;
+    pte_t*                  ptSlot;
+    vptr_t                  vaddr;
+    vm_attributes_t         attr;
+    word_t                  i;
+
+    ret.donated = false;
+    ret.cap = cap;
+    ret.vaddr = 0;
+
+    /* only small frames that are unmapped or mapped in a native vspace */
+    if (cap_get_capType(cap) != cap_frame_cap ||
+            cap_frame_cap_get_capFSize(cap) != X86_SmallPage ||
+            (cap_frame_cap_get_capFMapType(cap) != X86_MappingNone &&
+             cap_frame_cap_get_capFMapType(cap) != X86_MappingVSpace)) {
+        return ret;
+    }
+
+    vspaceCap = TCB_PTR_CTE_PTR(receiver, tcbVTable)->cap;
+    if (!isValidNativeRoot(vspaceCap)) {
+        return ret;
+    }
+    vspace = (vspace_root_t*)pptr_of_cap(vspaceCap);
+    asid = cap_get_capMappedASID(vspaceCap);
+
+    find_ret = findVSpaceForASID(asid);
+    if (find_ret.status != EXCEPTION_NONE || find_ret.vspace_root != vspace) {
+        return ret;
+    }
+
+    /* the window never crosses a page table, so one lookup covers it */
+    lu_ret = lookupPTSlot(vspace, receiver->tcbDonationWindow);
+    if (lu_ret.status != EXCEPTION_NONE) {
+        return ret;
+    }
+
+    ptSlot = NULL;
+    vaddr = 0;
+    for (i = 0; i < receiver->tcbDonationWindowPages; i++) {
+        vaddr = receiver->tcbDonationWindow + (i << PAGE_BITS);
+        if (vaddr >= PPTR_USER_TOP) {
+            return ret;
+        }
+        if (!pte_ptr_get_present(lu_ret.ptSlot + i)) {
+            ptSlot = lu_ret.ptSlot + i;
+            break;
+        }
+    }
+    if (!ptSlot) {
+        return ret;
+    }
+
+    /* The frame keeps the cacheability it was mapped with. A frame cap
+     * records no attributes, so an unmapped frame is mapped write-back. */
+    attr = vmAttributesFromWord(0);
+    if (cap_frame_cap_get_capFMappedASID(cap) != asidInvalid) {
+        find_ret = findVSpaceForASID(cap_frame_cap_get_capFMappedASID(cap));
+        if (find_ret.status == EXCEPTION_NONE) {
+            lu_ret = lookupPTSlot(find_ret.vspace_root, cap_frame_cap_get_capFMappedAddress(cap));
+            if (lu_ret.status == EXCEPTION_NONE && pte_ptr_get_present(lu_ret.ptSlot) &&
+                    pte_ptr_get_page_base_address(lu_ret.ptSlot) ==
+                    pptr_to_paddr((void *)cap_frame_cap_get_capFBasePtr(cap))) {
+                attr = vm_attributes_new(pte_ptr_get_pat(lu_ret.ptSlot),
+                                         pte_ptr_get_cache_disabled(lu_ret.ptSlot),
+                                         pte_ptr_get_write_through(lu_ret.ptSlot));
+            }
+        }
+    }
+
+    /* Taking away the sender's mapping is the only operation that needs
+     * a TLB invalidation. The page table of the window is already present
+     * and the slot is not, so nothing about it can be cached and the new
+     * mapping needs no invalidation of its own. */
+    if (cap_frame_cap_get_capFMappedASID(cap) != asidInvalid) {
+        unmapPage(
+            X86_SmallPage,
+            cap_frame_cap_get_capFMappedASID(cap),
+            cap_frame_cap_get_capFMappedAddress(cap),
+            (void *)cap_frame_cap_get_capFBasePtr(cap)
+        );
+    }
+
+    *ptSlot = makeUserPTE(pptr_to_paddr((void *)cap_frame_cap_get_capFBasePtr(cap)),
+                          attr,
+                          cap_frame_cap_get_capFVMRights(cap));
+
+    cap = cap_frame_cap_set_capFMappedASID(cap, asid);
+    cap = cap_frame_cap_set_capFMappedAddress(cap, vaddr);
+    cap = cap_frame_cap_set_capFMapType(cap, X86_MappingVSpace);
+
+    ret.donated = true;
+    ret.cap = cap;
+    ret.vaddr = vaddr;
+    return ret;
+}
+#endif /* CONFIG_FRAME_DONATION */
+
 exception_t decodeX86FrameInvocation(
     word_t invLabel,
     word_t length,
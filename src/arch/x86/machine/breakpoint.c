@@ -19,6 +19,7 @@
 #include <arch/machine.h>
 #include <machine/registerset.h>
 #include <plat/api/constants.h> /* seL4_NumHWBReakpoints */
+#include <model/kernel_stats.h>
 
 /* Intel manual Vol3, 17.2.4 */
 #define X86_DEBUG_BP_SIZE_1B                (0x0u)
@@ -621,6 +622,7 @@ handleUserLevelDebugException(int int_vector)
 #else
     (void)int_vector;
 #endif /* DEBUG */
+    KERNEL_STATS_INC(seL4_KernelStats_DebugFaults);
 
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
     benchmark_track_start();
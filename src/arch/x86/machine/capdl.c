@@ -179,7 +179,7 @@ static void sendIOPT(unsigned long address, unsigned int level)
 #ifdef CONFIG_ARCH_IA32
             sendWord(vtd_pte.words[1]);
 #endif
-            if (level == x86KSnumIOPTLevels) {
+            if (level == x86KSnumIOPTLevels || vtd_pte_get_super_page(vtd_pte)) {
                 sendWord(1);
             } else {
                 sendWord(0);
@@ -59,6 +59,7 @@ uint32_t x86KSnumDrhu;
 /* Intel VT-d Root Entry Table */
 vtd_rte_t* x86KSvtdRootTable;
 uint32_t x86KSnumIOPTLevels;
+uint32_t x86KSnumIOSuperPageLevels;
 uint32_t x86KSnumIODomainIDBits;
 uint32_t x86KSFirstValidIODomain;
 
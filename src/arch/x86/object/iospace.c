@@ -97,7 +97,8 @@ lookupIOPTSlot_resolve_levels(vtd_pte_t *iopt, word_t translation,
     iopt_index = (translation  >> (VTD_PT_INDEX_BITS * (x86KSnumIOPTLevels - 1 - (levels_to_resolve - levels_remaining)))) & MASK(VTD_PT_INDEX_BITS);
     iopt_slot = iopt + iopt_index;
 
-    if (!vtd_pte_ptr_get_write(iopt_slot) || levels_remaining == 0) {
+    if (!vtd_pte_ptr_get_write(iopt_slot) || vtd_pte_ptr_get_super_page(iopt_slot) ||
+            levels_remaining == 0) {
         ret.ioptSlot = iopt_slot;
         ret.level = levels_remaining;
         ret.status = EXCEPTION_NONE;
@@ -124,6 +125,20 @@ lookupIOPTSlot(vtd_pte_t* iopt, word_t io_address)
     }
 }
 
+/* Returns the level, counted up from the bottom of the IO page tables, at
+ * which a single entry maps a frame of the given size, or -1 if no level the
+ * IOMMUs support does */
+static int
+ioptLevelForFrameSize(vm_page_size_t frameSize)
+{
+    word_t bits = pageBitsForSize(frameSize) - seL4_PageBits;
+
+    if (bits % VTD_PT_INDEX_BITS != 0 || bits / VTD_PT_INDEX_BITS > x86KSnumIOSuperPageLevels) {
+        return -1;
+    }
+    return bits / VTD_PT_INDEX_BITS;
+}
+
 void
 unmapVTDContextEntry(cap_t cap)
 {
@@ -279,6 +294,7 @@ decodeX86IOPTInvocation(
 
         iopte = vtd_pte_new(
                     paddr,      /* physical addr            */
+                    0,          /* super page               */
                     1,          /* write permission flag    */
                     1           /* read  permission flag    */
                 );
@@ -323,6 +339,7 @@ decodeX86IOMapInvocation(
     lookupIOPTSlot_ret_t lu_ret;
     vm_rights_t frame_cap_rights;
     seL4_CapRights_t dma_cap_rights_mask;
+    int        level;
 
     if (excaps.excaprefs[0] == NULL || length < 2) {
         userError("X86PageMapIO: Truncated message.");
@@ -330,7 +347,8 @@ decodeX86IOMapInvocation(
         return EXCEPTION_SYSCALL_ERROR;
     }
 
-    if (cap_frame_cap_get_capFSize(cap) != X86_SmallPage) {
+    level = ioptLevelForFrameSize(cap_frame_cap_get_capFSize(cap));
+    if (level < 0) {
         userError("X86PageMapIO: Invalid page size.");
         current_syscall_error.type = seL4_InvalidCapability;
         current_syscall_error.invalidCapNumber = 0;
@@ -345,7 +363,7 @@ decodeX86IOMapInvocation(
     }
 
     io_space    = excaps.excaprefs[0]->cap;
-    io_address  = getSyscallArg(1, buffer) & ~MASK(PAGE_BITS);
+    io_address  = getSyscallArg(1, buffer) & ~MASK(pageBitsForSize(cap_frame_cap_get_capFSize(cap)));
     paddr       = pptr_to_paddr((void*)cap_frame_cap_get_capFBasePtr(cap));
 
     if (cap_get_capType(io_space) != cap_io_space_cap) {
@@ -375,13 +393,16 @@ decodeX86IOMapInvocation(
 
     vtd_pte = (vtd_pte_t*)paddr_to_pptr(vtd_cte_ptr_get_asr(vtd_context_slot));
     lu_ret  = lookupIOPTSlot(vtd_pte, io_address);
-    if (lu_ret.status != EXCEPTION_NONE || lu_ret.level != 0) {
+    if (lu_ret.status != EXCEPTION_NONE ||
+            (lu_ret.level > level && vtd_pte_ptr_get_addr(lu_ret.ioptSlot) == 0)) {
         current_syscall_error.type = seL4_FailedLookup;
         current_syscall_error.failedLookupWasSource = false;
         return EXCEPTION_SYSCALL_ERROR;
     }
 
-    if (vtd_pte_ptr_get_addr(lu_ret.ioptSlot) != 0) {
+    /* Either the slot is in use, or a page table or a larger frame covers
+     * the range */
+    if (lu_ret.level != level || vtd_pte_ptr_get_addr(lu_ret.ioptSlot) != 0) {
         current_syscall_error.type = seL4_DeleteFirst;
         return EXCEPTION_SYSCALL_ERROR;
     }
@@ -392,7 +413,7 @@ decodeX86IOMapInvocation(
     bool_t write = seL4_CapRights_get_capAllowWrite(dma_cap_rights_mask) && (frame_cap_rights == VMReadWrite);
     bool_t read = seL4_CapRights_get_capAllowRead(dma_cap_rights_mask) && (frame_cap_rights != VMKernelOnly);
     if (write || read) {
-        iopte = vtd_pte_new(paddr, !!write, !!read);
+        iopte = vtd_pte_new(paddr, level != 0, !!write, !!read);
     } else {
         current_syscall_error.type = seL4_InvalidArgument;
         current_syscall_error.invalidArgumentNumber = 0;
@@ -453,6 +474,7 @@ void deleteIOPageTable(cap_t io_pt_cap)
             }
             *lu_ret.ioptSlot = vtd_pte_new(
                                    0,  /* Physical Address */
+                                   0,  /* Super Page       */
                                    0,  /* Read Permission  */
                                    0   /* Write Permission */
                                );
@@ -480,7 +502,8 @@ void unmapIOPage(cap_t cap)
     vtd_pte = (vtd_pte_t*)paddr_to_pptr(vtd_cte_ptr_get_asr(vtd_context_slot));
 
     lu_ret  = lookupIOPTSlot(vtd_pte, io_address);
-    if (lu_ret.status != EXCEPTION_NONE || lu_ret.level != 0) {
+    if (lu_ret.status != EXCEPTION_NONE ||
+            lu_ret.level != ioptLevelForFrameSize(cap_frame_cap_get_capFSize(cap))) {
         return;
     }
 
@@ -490,6 +513,7 @@ void unmapIOPage(cap_t cap)
 
     *lu_ret.ioptSlot = vtd_pte_new(
                            0,  /* Physical Address */
+                           0,  /* Super Page       */
                            0,  /* Read Permission  */
                            0   /* Write Permission */
                        );
@@ -25,6 +25,7 @@
 #include <arch/object/vcpu.h>
 #include <util.h>
 #include <arch/api/vmenter.h>
+#include <model/kernel_stats.h>
 
 #define VMX_EXIT_QUAL_TYPE_MOV_CR 0
 #define VMX_EXIT_QUAL_TYPE_CLTS 2
@@ -84,6 +85,7 @@ static uint32_t cr4_low;
 static bool_t vmx_feature_vpid;
 static bool_t vmx_feature_load_perf_global_ctrl;
 static bool_t vmx_feature_ack_on_exit;
+static bool_t vmx_feature_ept_ad;
 
 static vcpu_t *x86KSVPIDTable[VPID_LAST + 1];
 static vpid_t x86KSNextVPID = VPID_FIRST;
@@ -1104,6 +1106,10 @@ vtx_init(void)
         return false;
     }
 
+    /* Accessed and dirty flags are optional, and only needed to harvest
+     * them from guest memory */
+    vmx_feature_ept_ad = vmx_ept_vpid_cap_msr_get_ept_flags(vpid_capability);
+
     return true;
 }
 
@@ -1182,6 +1188,7 @@ handleVmexit(void)
     word_t qualification;
     uint32_t reason;
     finishVmexitSaving();
+    KERNEL_STATS_INC(seL4_KernelStats_VMExits);
     /* the basic exit reason is the bottom 16 bits of the exit reason field */
     reason = vmread(VMX_DATA_EXIT_REASON) & MASK(16);
     if (reason == EXTERNAL_INTERRUPT) {
@@ -1370,6 +1377,9 @@ static void
 setEPTRoot(cap_t vmxSpace, vcpu_t* vcpu)
 {
     paddr_t ept_root;
+    bool_t accessedDirty = false;
+    vmx_eptp_t eptp;
+
     if (cap_get_capType(vmxSpace) != cap_ept_pml4_cap ||
             !cap_ept_pml4_cap_get_capPML4IsMapped(vmxSpace)) {
         ept_root = kpptr_to_paddr(null_ept_space);
@@ -1383,16 +1393,17 @@ setEPTRoot(cap_t vmxSpace, vcpu_t* vcpu)
             ept_root = kpptr_to_paddr(null_ept_space);
         } else {
             ept_root = pptr_to_paddr(pml4);
+            accessedDirty = find_ret.accessedDirty;
         }
     }
-    if (ept_root != vcpu->last_ept_root) {
-        vcpu->last_ept_root = ept_root;
-        vmx_eptp_t eptp = vmx_eptp_new(
-                              ept_root,       /* paddr of ept */
-                              0,              /* do not use accessed and dirty flags */
-                              3,              /* depth (4) minus 1 of desired table walking */
-                              6               /* write back memory type */
-                          );
+    eptp = vmx_eptp_new(
+               ept_root,       /* paddr of ept */
+               accessedDirty,  /* use accessed and dirty flags */
+               3,              /* depth (4) minus 1 of desired table walking */
+               6               /* write back memory type */
+           );
+    if (eptp.words[0] != vcpu->last_ept_root) {
+        vcpu->last_ept_root = eptp.words[0];
         vmwrite(VMX_CONTROL_EPT_POINTER, eptp.words[0]);
         assert(vcpu->vpid != VPID_INVALID);
         if (vmx_feature_vpid) {
@@ -1549,6 +1560,12 @@ restoreVMCS(void)
     handleLazyFpu();
 }
 
+bool_t
+vtx_ept_ad_enabled(void)
+{
+    return vmx_feature_ept_ad;
+}
+
 void
 invept(ept_pml4e_t *ept_pml4)
 {
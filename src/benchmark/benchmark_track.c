@@ -11,6 +11,8 @@
 #include <config.h>
 #include <benchmark/benchmark_track.h>
 #include <model/statedata.h>
+#include <api/failures.h>
+#include <kernel/vspace.h>
 
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
 
@@ -18,6 +20,153 @@ timestamp_t ksEnter;
 seL4_Word ksLogIndex;
 seL4_Word ksLogIndexFinalized;
 
+#ifdef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG
+
+timestamp_t ksWatchdogThreshold = CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG_THRESHOLD;
+
+static inline bool_t
+benchmark_watchdog_is_max(word_t index, uint32_t duration)
+{
+    return duration > NODE_STATE(ksWatchdogMax)[index].duration;
+}
+
+static inline void
+benchmark_watchdog_update_max(word_t index, benchmark_watchdog_entry_t *entry)
+{
+    if (benchmark_watchdog_is_max(index, entry->duration)) {
+        NODE_STATE(ksWatchdogMax)[index] = *entry;
+    }
+}
+
+/* Only outliers are kept, the user log buffer is not written */
+void benchmark_track_exit(void)
+{
+    benchmark_watchdog_entry_t entry;
+    timestamp_t duration = timestamp() - ksEnter;
+    word_t syscallIndex = BENCHMARK_WATCHDOG_MAX_SYSCALL + ksKernelEntry.syscall_no;
+    word_t capTypeIndex = BENCHMARK_WATCHDOG_MAX_CAP_TYPE + ksKernelEntry.cap_type;
+    bool_t isSyscall = ksKernelEntry.path == Entry_Syscall;
+    bool_t isOutlier;
+
+    /* Saturate rather than wrap entries too long for the log format */
+    if (unlikely(duration > 0xffffffffu)) {
+        duration = 0xffffffffu;
+    }
+
+    /* Keep the common case to a few compares */
+    isOutlier = duration > ksWatchdogThreshold;
+    if (likely(!isOutlier &&
+               !benchmark_watchdog_is_max(ksKernelEntry.path, duration) &&
+               !(isSyscall && (benchmark_watchdog_is_max(syscallIndex, duration) ||
+                               benchmark_watchdog_is_max(capTypeIndex, duration))))) {
+        return;
+    }
+
+    entry.start_time = ksEnter;
+    entry.duration = duration;
+    entry.entry = ksKernelEntry;
+    entry.core = SMP_TERNARY(getCurrentCPUIndex(), 0);
+    entry.preemption_points = NODE_STATE(ksWatchdogPreemptionPoints);
+    entry.cur_thread = (word_t)NODE_STATE(ksWatchdogEntryThread);
+    entry.next_thread = (word_t)NODE_STATE(ksCurThread);
+#ifdef CONFIG_THREAD_REGISTRY
+    entry.thread_tag = NODE_STATE(ksKernelEntryTag);
+#endif
+
+    if (isOutlier) {
+        NODE_STATE(ksWatchdogLog)[NODE_STATE(ksWatchdogLogIndex) %
+                                  CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG_ENTRIES] = entry;
+        NODE_STATE(ksWatchdogLogIndex)++;
+    }
+
+    benchmark_watchdog_update_max(ksKernelEntry.path, &entry);
+    if (isSyscall) {
+        benchmark_watchdog_update_max(syscallIndex, &entry);
+        benchmark_watchdog_update_max(capTypeIndex, &entry);
+    }
+}
+
+void
+benchmark_watchdog_reset(timestamp_t threshold)
+{
+    word_t i;
+
+    if (threshold != 0) {
+        ksWatchdogThreshold = threshold;
+    }
+
+    /* Remote cores may be capturing an entry concurrently; at worst a
+     * single entry survives the reset */
+    for (i = 0; i < ksNumCPUs; i++) {
+        NODE_STATE_ON_CORE(ksWatchdogLogIndex, i) = 0;
+        memzero(NODE_STATE_ON_CORE(ksWatchdogMax, i), sizeof(NODE_STATE_ON_CORE(ksWatchdogMax, i)));
+    }
+}
+
+exception_t
+benchmark_watchdog_dump(word_t node, word_t table, word_t first)
+{
+    seL4_IPCBuffer *buffer;
+    benchmark_watchdog_entry_t *entries;
+    word_t start, count, size, i;
+
+    if (node >= ksNumCPUs) {
+        userError("BenchmarkWatchdogDump: Invalid node %lu.", node);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = ksNumCPUs - 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (table == BENCHMARK_WATCHDOG_LOG) {
+        word_t total = NODE_STATE_ON_CORE(ksWatchdogLogIndex, node);
+        entries = NODE_STATE_ON_CORE(ksWatchdogLog, node);
+        size = CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG_ENTRIES;
+        count = MIN(total, size);
+        start = total - count;
+    } else if (table == BENCHMARK_WATCHDOG_MAX) {
+        entries = NODE_STATE_ON_CORE(ksWatchdogMax, node);
+        size = BENCHMARK_WATCHDOG_MAX_ENTRIES;
+        count = size;
+        start = 0;
+    } else {
+        userError("BenchmarkWatchdogDump: Invalid table %lu.", table);
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (first > count) {
+        userError("BenchmarkWatchdogDump: Invalid first entry %lu.", first);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = count;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    buffer = (seL4_IPCBuffer *)lookupIPCBuffer(true, NODE_STATE(ksCurThread));
+    if (!buffer) {
+        userError("BenchmarkWatchdogDump: Failed to lookup IPC buffer.");
+        current_syscall_error.type = seL4_IllegalOperation;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* Entries are copied bytewise as the message registers need not be
+     * aligned for the 64 bit start time */
+    for (i = 0; first + i < count &&
+            (i + 1) * sizeof(benchmark_watchdog_entry_t) <= sizeof(buffer->msg); i++) {
+        memcpy((char *)buffer->msg + i * sizeof(benchmark_watchdog_entry_t),
+               &entries[(start + first + i) % size],
+               sizeof(benchmark_watchdog_entry_t));
+    }
+
+    /* Number of entries written */
+    setRegister(NODE_STATE(ksCurThread), msgInfoRegister, i);
+    return EXCEPTION_NONE;
+}
+
+#else
+
 void benchmark_track_exit(void)
 {
     timestamp_t duration = 0;
@@ -31,8 +180,13 @@ void benchmark_track_exit(void)
             ksLog[ksLogIndex].entry = ksKernelEntry;
             ksLog[ksLogIndex].start_time = ksEnter;
             ksLog[ksLogIndex].duration = duration;
+#ifdef CONFIG_THREAD_REGISTRY
+            ksLog[ksLogIndex].thread_tag = NODE_STATE(ksKernelEntryTag);
+#endif
             ksLogIndex++;
         }
     }
 }
+
+#endif /* CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG */
 #endif /* CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES */
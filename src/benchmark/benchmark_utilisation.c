@@ -25,6 +25,7 @@ void benchmark_track_utilisation_dump(void)
     word_t tcb_cptr = getRegister(NODE_STATE(ksCurThread), capRegister);
     lookupCap_ret_t lu_ret;
     word_t cap_type;
+    word_t i;
 
     lu_ret = lookupCap(NODE_STATE(ksCurThread), tcb_cptr);
     /* ensure we got a TCB cap */
@@ -37,6 +38,14 @@ void benchmark_track_utilisation_dump(void)
     tcb = TCB_PTR(cap_thread_cap_get_capTCBPtr(lu_ret.cap));
     buffer[BENCHMARK_TCB_UTILISATION] = tcb->benchmark.utilisation; /* Requested thread utilisation */
     buffer[BENCHMARK_IDLE_UTILISATION] = NODE_STATE(ksIdleThread)->benchmark.utilisation; /* Idle thread utilisation */
+    buffer[BENCHMARK_TCB_USER_TIME] = tcb->benchmark.user_time; /* Requested thread time at user level */
+    for (i = 0; i < BENCHMARK_KERNEL_TIME_NUM_CAUSES; i++) {
+        /* Requested thread kernel time by cause */
+        buffer[BENCHMARK_TCB_KERNEL_TIME + i] = tcb->benchmark.kernel_time[i];
+    }
+#ifdef CONFIG_THREAD_REGISTRY
+    buffer[BENCHMARK_TCB_TAG] = tcb->tcbTag;
+#endif
 
 #ifdef CONFIG_ARM_ENABLE_PMU_OVERFLOW_INTERRUPT
     buffer[BENCHMARK_TOTAL_UTILISATION] =
@@ -66,5 +75,7 @@ void benchmark_track_reset_utilisation(void)
 
     tcb->benchmark.utilisation = 0;
     tcb->benchmark.schedule_start_time = 0;
+    tcb->benchmark.user_time = 0;
+    memzero(tcb->benchmark.kernel_time, sizeof(tcb->benchmark.kernel_time));
 }
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
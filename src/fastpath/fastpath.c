@@ -10,12 +10,88 @@
 
 #include <config.h>
 #include <fastpath/fastpath.h>
+#include <model/kernel_stats.h>
 
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
 #include <benchmark/benchmark_track.h>
 #endif
 #include <benchmark/benchmark_utilisation.h>
 
+/* The single extra cap of a message and where it goes. A NULL destSlot
+ * means the cap is unwrapped into a badge. */
+typedef struct fastpath_cap_transfer {
+    cte_t *srcSlot;
+    cte_t *destSlot;
+    cap_t cap;
+    word_t *receiveBuffer;
+} fastpath_cap_transfer_t;
+
+/* Check that the extra cap can be transferred the way transferCaps would,
+ * without any of its failure cases: it is either a cap to the endpoint the
+ * message goes through, or it can be derived into an empty receive slot. */
+static inline bool_t FORCE_INLINE
+fastpath_cap_transfer_check(tcb_t *sender, tcb_t *receiver,
+                            endpoint_t *ep_ptr, fastpath_cap_transfer_t *ct)
+{
+    word_t *sendBuffer;
+    deriveCap_ret_t dc_ret;
+
+    sendBuffer = lookupIPCBuffer(false, sender);
+    ct->receiveBuffer = lookupIPCBuffer(true, receiver);
+    if (unlikely(!sendBuffer || !ct->receiveBuffer)) {
+        return false;
+    }
+
+    ct->srcSlot = lookup_slot_fp(TCB_PTR_CTE_PTR(sender, tcbCTable),
+                                 getExtraCPtr(sendBuffer, 0));
+    if (unlikely(!ct->srcSlot)) {
+        return false;
+    }
+    ct->cap = ct->srcSlot->cap;
+
+    if (cap_capType_equals(ct->cap, cap_endpoint_cap) &&
+            EP_PTR(cap_endpoint_cap_get_capEPPtr(ct->cap)) == ep_ptr) {
+        ct->destSlot = NULL;
+        return true;
+    }
+
+#ifdef CONFIG_FRAME_DONATION
+    /* Donated frames are moved and mapped by the slowpath */
+    if (unlikely(sender->tcbDonateFrames && receiver->tcbDonationWindowPages)) {
+        return false;
+    }
+#endif
+
+    ct->destSlot = getReceiveSlots(receiver, ct->receiveBuffer);
+    if (unlikely(!ct->destSlot)) {
+        return false;
+    }
+
+    dc_ret = deriveCap(ct->srcSlot, ct->cap);
+    if (unlikely(dc_ret.status != EXCEPTION_NONE ||
+                 cap_capType_equals(dc_ret.cap, cap_null_cap))) {
+        return false;
+    }
+    ct->cap = dc_ret.cap;
+
+    return true;
+}
+
+static inline seL4_MessageInfo_t FORCE_INLINE
+fastpath_cap_transfer(seL4_MessageInfo_t info, tcb_t *receiver,
+                      fastpath_cap_transfer_t *ct)
+{
+    if (!ct->destSlot) {
+        setExtraBadge(ct->receiveBuffer,
+                      cap_endpoint_cap_get_capEPBadge(ct->cap), 0);
+        return seL4_MessageInfo_set_capsUnwrapped(info, 1);
+    }
+
+    cteInsert(ct->cap, ct->srcSlot, ct->destSlot);
+
+    return info;
+}
+
 void
 #ifdef ARCH_X86
 NORETURN
@@ -33,21 +109,24 @@ fastpath_call(word_t cptr, word_t msgInfo)
     vspace_root_t *cap_pd;
     pde_t stored_hw_asid;
     word_t fault_type;
+    word_t extraCaps;
+    fastpath_cap_transfer_t ct = { .srcSlot = NULL };
 
     /* Get message info, length, and fault type. */
     info = messageInfoFromWord_raw(msgInfo);
     length = seL4_MessageInfo_get_length(info);
+    extraCaps = seL4_MessageInfo_get_extraCaps(info);
     fault_type = seL4_Fault_get_seL4_FaultType(NODE_STATE(ksCurThread)->tcbFault);
 
-    /* Check there's no extra caps, the length is ok and there's no
-     * saved fault. */
-    if (unlikely(fastpath_mi_check(msgInfo) ||
+    /* Check there's at most one extra cap, the length is ok and there's
+     * no saved fault. */
+    if (unlikely(fastpath_mi_check(fastpath_mi_clear_one_cap(msgInfo)) ||
                  fault_type != seL4_Fault_NullFault)) {
         slowpath(SysCall);
     }
 
     /* Lookup the cap */
-    ep_cap = lookup_fp(TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbCTable)->cap, cptr);
+    ep_cap = lookup_fp(TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbCTable), cptr);
 
     /* Check it's an endpoint */
     if (unlikely(!cap_capType_equals(ep_cap, cap_endpoint_cap) ||
@@ -67,6 +146,13 @@ fastpath_call(word_t cptr, word_t msgInfo)
         slowpath(SysCall);
     }
 
+#ifdef CONFIG_KERNEL_TIMEOUTS
+    /* Ensure the destination has no timeout to disarm */
+    if (unlikely(dest->tcbSleeping)) {
+        slowpath(SysCall);
+    }
+#endif
+
     /* ensure we are not single stepping the destination in ia32 */
 #if defined(CONFIG_HARDWARE_DEBUG_API) && defined(CONFIG_ARCH_IA32)
     if (dest->tcbArch.tcbContext.breakpointState.single_step_enabled) {
@@ -101,7 +187,15 @@ fastpath_call(word_t cptr, word_t msgInfo)
 
     /* Ensure the destination has a higher/equal priority to us. */
     if (unlikely(dest->tcbPriority < NODE_STATE(ksCurThread)->tcbPriority)) {
+#ifdef CONFIG_PRIORITY_INHERITANCE
+        /* It may still run directly if it inherits all of ours */
+        if (!dest->tcbInheritPriority ||
+                dest->tcbMCP < NODE_STATE(ksCurThread)->tcbPriority) {
+            slowpath(SysCall);
+        }
+#else
         slowpath(SysCall);
+#endif
     }
 
     /* Ensure that the endpoint has has grant rights so that we can
@@ -128,6 +222,12 @@ fastpath_call(word_t cptr, word_t msgInfo)
     }
 #endif /* ENABLE_SMP_SUPPORT */
 
+    /* Ensure the extra cap, if any, can be transferred */
+    if (unlikely(extraCaps) &&
+            unlikely(!fastpath_cap_transfer_check(NODE_STATE(ksCurThread), dest, ep_ptr, &ct))) {
+        slowpath(SysCall);
+    }
+
     /*
      * --- POINT OF NO RETURN ---
      *
@@ -137,6 +237,12 @@ fastpath_call(word_t cptr, word_t msgInfo)
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
     ksKernelEntry.is_fastpath = true;
 #endif
+    KERNEL_STATS_INC(seL4_KernelStats_Syscalls);
+    KERNEL_STATS_INC(seL4_KernelStats_FastpathCalls);
+    KERNEL_STATS_INC(seL4_KernelStats_ContextSwitches);
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    benchmark_utilisation_kentry_cause(BENCHMARK_KERNEL_TIME_FASTPATH);
+#endif
 
     /* Dequeue the destination. */
     endpoint_ptr_set_epQueue_head_np(ep_ptr, TCB_REF(dest->tcbEPNext));
@@ -166,12 +272,23 @@ fastpath_call(word_t cptr, word_t msgInfo)
 
     fastpath_copy_mrs (length, NODE_STATE(ksCurThread), dest);
 
+    info = seL4_MessageInfo_set_capsUnwrapped(info, 0);
+    if (unlikely(extraCaps)) {
+        info = fastpath_cap_transfer(info, dest, &ct);
+    }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    /* Raise the destination to our priority while it is still blocked, so
+     * that it is not queued at either priority */
+    inheritPriority(dest, NODE_STATE(ksCurThread));
+#endif
+
     /* Dest thread is set Running, but not queued. */
     thread_state_ptr_set_tsType_np(&dest->tcbState,
                                    ThreadState_Running);
     switchToThread_fp(dest, cap_pd, stored_hw_asid);
 
-    msgInfo = wordFromMessageInfo(seL4_MessageInfo_set_capsUnwrapped(info, 0));
+    msgInfo = wordFromMessageInfo(info);
 
     fastpath_restore(badge, msgInfo, NODE_STATE(ksCurThread));
 }
@@ -189,25 +306,29 @@ fastpath_reply_recv(word_t cptr, word_t msgInfo)
     word_t badge;
     tcb_t *endpointTail;
     word_t fault_type;
+    bool_t signalPending;
 
     cap_t newVTable;
     vspace_root_t *cap_pd;
     pde_t stored_hw_asid;
+    word_t extraCaps;
+    fastpath_cap_transfer_t ct = { .srcSlot = NULL };
 
     /* Get message info and length */
     info = messageInfoFromWord_raw(msgInfo);
     length = seL4_MessageInfo_get_length(info);
+    extraCaps = seL4_MessageInfo_get_extraCaps(info);
     fault_type = seL4_Fault_get_seL4_FaultType(NODE_STATE(ksCurThread)->tcbFault);
 
-    /* Check there's no extra caps, the length is ok and there's no
-     * saved fault. */
-    if (unlikely(fastpath_mi_check(msgInfo) ||
+    /* Check there's at most one extra cap, the length is ok and there's
+     * no saved fault. */
+    if (unlikely(fastpath_mi_check(fastpath_mi_clear_one_cap(msgInfo)) ||
                  fault_type != seL4_Fault_NullFault)) {
         slowpath(SysReplyRecv);
     }
 
     /* Lookup the cap */
-    ep_cap = lookup_fp(TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbCTable)->cap,
+    ep_cap = lookup_fp(TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbCTable),
                        cptr);
 
     /* Check it's an endpoint */
@@ -216,17 +337,16 @@ fastpath_reply_recv(word_t cptr, word_t msgInfo)
         slowpath(SysReplyRecv);
     }
 
-    /* Check there is nothing waiting on the notification */
-    if (NODE_STATE(ksCurThread)->tcbBoundNotification &&
-            notification_ptr_get_state(NODE_STATE(ksCurThread)->tcbBoundNotification) == NtfnState_Active) {
-        slowpath(SysReplyRecv);
-    }
+    /* Check whether a signal is waiting on the bound notification, which
+     * the receive returns instead of blocking */
+    signalPending = NODE_STATE(ksCurThread)->tcbBoundNotification &&
+                    notification_ptr_get_state(NODE_STATE(ksCurThread)->tcbBoundNotification) == NtfnState_Active;
 
     /* Get the endpoint address */
     ep_ptr = EP_PTR(cap_endpoint_cap_get_capEPPtr(ep_cap));
 
     /* Check that there's not a thread waiting to send */
-    if (unlikely(endpoint_ptr_get_state(ep_ptr) == EPState_Send)) {
+    if (unlikely(!signalPending && endpoint_ptr_get_state(ep_ptr) == EPState_Send)) {
         slowpath(SysReplyRecv);
     }
 
@@ -302,6 +422,21 @@ fastpath_reply_recv(word_t cptr, word_t msgInfo)
     }
 #endif /* ENABLE_SMP_SUPPORT */
 
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    /* Dropping a priority inherited from the caller is left to the
+     * slowpath's scheduler helpers */
+    if (unlikely(NODE_STATE(ksCurThread)->tcbBoosted)) {
+        slowpath(SysReplyRecv);
+    }
+#endif
+
+    /* Ensure the extra cap, if any, can be transferred. Replies are not
+     * sent through an endpoint, so the cap is never unwrapped. */
+    if (unlikely(extraCaps) &&
+            unlikely(!fastpath_cap_transfer_check(NODE_STATE(ksCurThread), caller, NULL, &ct))) {
+        slowpath(SysReplyRecv);
+    }
+
     /*
      * --- POINT OF NO RETURN ---
      *
@@ -311,30 +446,47 @@ fastpath_reply_recv(word_t cptr, word_t msgInfo)
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
     ksKernelEntry.is_fastpath = true;
 #endif
+    KERNEL_STATS_INC(seL4_KernelStats_Syscalls);
+    KERNEL_STATS_INC(seL4_KernelStats_FastpathReplyRecvs);
+    KERNEL_STATS_INC(seL4_KernelStats_ContextSwitches);
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    benchmark_utilisation_kentry_cause(BENCHMARK_KERNEL_TIME_FASTPATH);
+#endif
 
-    /* Set thread state to BlockedOnReceive */
-    thread_state_ptr_mset_blockingObject_tsType(
-        &NODE_STATE(ksCurThread)->tcbState, (word_t)ep_ptr, ThreadState_BlockedOnReceive);
-
-    /* Place the thread in the endpoint queue */
-    endpointTail = endpoint_ptr_get_epQueue_tail_fp(ep_ptr);
-    if (likely(!endpointTail)) {
-        NODE_STATE(ksCurThread)->tcbEPPrev = NULL;
-        NODE_STATE(ksCurThread)->tcbEPNext = NULL;
-
-        /* Set head/tail of queue and endpoint state. */
-        endpoint_ptr_set_epQueue_head_np(ep_ptr, TCB_REF(NODE_STATE(ksCurThread)));
-        endpoint_ptr_mset_epQueue_tail_state(ep_ptr, TCB_REF(NODE_STATE(ksCurThread)),
-                                             EPState_Recv);
+    if (unlikely(signalPending)) {
+        /* Take the signal as receiveIPC would. The thread stays runnable,
+         * so it goes back on its ready queue as we switch to the caller. */
+        completeSignal(NODE_STATE(ksCurThread)->tcbBoundNotification,
+                       NODE_STATE(ksCurThread));
+        SCHED_ENQUEUE_CURRENT_TCB;
     } else {
-        /* Append current thread onto the queue. */
-        endpointTail->tcbEPNext = NODE_STATE(ksCurThread);
-        NODE_STATE(ksCurThread)->tcbEPPrev = endpointTail;
-        NODE_STATE(ksCurThread)->tcbEPNext = NULL;
+        /* Set thread state to BlockedOnReceive */
+        thread_state_ptr_mset_blockingObject_tsType(
+            &NODE_STATE(ksCurThread)->tcbState, (word_t)ep_ptr, ThreadState_BlockedOnReceive);
 
-        /* Update tail of queue. */
-        endpoint_ptr_mset_epQueue_tail_state(ep_ptr, TCB_REF(NODE_STATE(ksCurThread)),
-                                             EPState_Recv);
+        /* Place the thread in the endpoint queue */
+#ifdef CONFIG_MULTICAST
+        NODE_STATE(ksCurThread)->tcbRecvStamp = ksRecvStamp++;
+#endif
+        endpointTail = endpoint_ptr_get_epQueue_tail_fp(ep_ptr);
+        if (likely(!endpointTail)) {
+            NODE_STATE(ksCurThread)->tcbEPPrev = NULL;
+            NODE_STATE(ksCurThread)->tcbEPNext = NULL;
+
+            /* Set head/tail of queue and endpoint state. */
+            endpoint_ptr_set_epQueue_head_np(ep_ptr, TCB_REF(NODE_STATE(ksCurThread)));
+            endpoint_ptr_mset_epQueue_tail_state(ep_ptr, TCB_REF(NODE_STATE(ksCurThread)),
+                                                 EPState_Recv);
+        } else {
+            /* Append current thread onto the queue. */
+            endpointTail->tcbEPNext = NODE_STATE(ksCurThread);
+            NODE_STATE(ksCurThread)->tcbEPPrev = endpointTail;
+            NODE_STATE(ksCurThread)->tcbEPNext = NULL;
+
+            /* Update tail of queue. */
+            endpoint_ptr_mset_epQueue_tail_state(ep_ptr, TCB_REF(NODE_STATE(ksCurThread)),
+                                                 EPState_Recv);
+        }
     }
 
     /* Delete the reply cap. */
@@ -351,12 +503,17 @@ fastpath_reply_recv(word_t cptr, word_t msgInfo)
 
     fastpath_copy_mrs (length, NODE_STATE(ksCurThread), caller);
 
+    info = seL4_MessageInfo_set_capsUnwrapped(info, 0);
+    if (unlikely(extraCaps)) {
+        info = fastpath_cap_transfer(info, caller, &ct);
+    }
+
     /* Dest thread is set Running, but not queued. */
     thread_state_ptr_set_tsType_np(&caller->tcbState,
                                    ThreadState_Running);
     switchToThread_fp(caller, cap_pd, stored_hw_asid);
 
-    msgInfo = wordFromMessageInfo(seL4_MessageInfo_set_capsUnwrapped(info, 0));
+    msgInfo = wordFromMessageInfo(info);
 
     fastpath_restore(badge, msgInfo, NODE_STATE(ksCurThread));
 }
@@ -240,6 +240,23 @@ create_bi_frame_cap(
     write_slot(SLOT_PTR(pptr_of_cap(root_cnode_cap), seL4_CapBootInfoFrame), cap);
 }
 
+BOOT_CODE word_t
+calculate_extra_bi_size_bits(word_t extra_size)
+{
+    if (extra_size == 0) {
+        return 0;
+    }
+
+    /* round up to the next power of 2 that is at least a page */
+    word_t clzl_ret = clzl(ROUND_UP(extra_size, seL4_PageBits));
+    word_t msb = seL4_WordBits - 1 - clzl_ret;
+    /* If region is bigger than a page, make sure we overallocate rather than underallocate */
+    if (extra_size > BIT(msb)) {
+        msb++;
+    }
+    return msb;
+}
+
 BOOT_CODE region_t
 allocate_extra_bi_region(word_t extra_size)
 {
@@ -250,7 +267,7 @@ allocate_extra_bi_region(word_t extra_size)
             0x1000, 0x1000
         };
     }
-    word_t size_bits = seL4_WordBits - 1 - clzl(ROUND_UP(extra_size, seL4_PageBits));
+    word_t size_bits = calculate_extra_bi_size_bits(extra_size);
     pptr_t pptr = alloc_region(size_bits);
     if (!pptr) {
         printf("Kernel init failed: could not allocate extra bootinfo region size bits %lu\n", size_bits);
@@ -492,35 +509,88 @@ init_core_state(tcb_t *scheduler_action)
     for (int i = 0; i < CONFIG_MAX_NUM_NODES; i++) {
         tcbDebugAppend(NODE_STATE_ON_CORE(ksIdleThread, i));
     }
+#endif
+#ifdef CONFIG_THREAD_REGISTRY
+    ksThreadRegistry = NULL;
+    if (scheduler_action != SchedulerAction_ResumeCurrentThread &&
+            scheduler_action != SchedulerAction_ChooseNewThread) {
+        tcbRegistryAppend(scheduler_action);
+    }
+    for (int i = 0; i < CONFIG_MAX_NUM_NODES; i++) {
+        tcbRegistryAppend(NODE_STATE_ON_CORE(ksIdleThread, i));
+    }
 #endif
     NODE_STATE(ksSchedulerAction) = scheduler_action;
     NODE_STATE(ksCurThread) = NODE_STATE(ksIdleThread);
 }
 
+/* Untyped caps that do not fit into untypedList are described in an extra
+ * bootinfo chunk, sized for as many untypeds as the root CNode can hold */
+BOOT_CODE word_t
+calculate_untyped_bi_size(void)
+{
+    word_t max_untypeds = BIT(CONFIG_ROOT_CNODE_SIZE_BITS) - seL4_NumInitialCaps;
+
+    if (max_untypeds <= CONFIG_MAX_NUM_BOOTINFO_UNTYPED_CAPS) {
+        return 0;
+    }
+    return sizeof(seL4_BootInfo_Untyped) +
+           (max_untypeds - CONFIG_MAX_NUM_BOOTINFO_UNTYPED_CAPS) * sizeof(seL4_UntypedDesc);
+}
+
+BOOT_CODE void
+populate_untyped_bi(pptr_t pptr, word_t size)
+{
+    seL4_BootInfo_Untyped *untyped_bi = (seL4_BootInfo_Untyped*)pptr;
+
+    untyped_bi->header.id = SEL4_BOOTINFO_HEADER_UNTYPED;
+    untyped_bi->header.len = size;
+    untyped_bi->numUntypeds = 0;
+    ndks_boot.untyped_bi = untyped_bi;
+    ndks_boot.untyped_bi_max = (size - sizeof(seL4_BootInfo_Untyped)) / sizeof(seL4_UntypedDesc);
+}
+
 BOOT_CODE static bool_t
 provide_untyped_cap(
     cap_t      root_cnode_cap,
     bool_t     device_memory,
     pptr_t     pptr,
     word_t     size_bits,
+    word_t     numa_node,
     seL4_SlotPos first_untyped_slot
 )
 {
-    bool_t ret;
     cap_t ut_cap;
+    seL4_UntypedDesc *desc;
     word_t i = ndks_boot.slot_pos_cur - first_untyped_slot;
+
     if (i < CONFIG_MAX_NUM_BOOTINFO_UNTYPED_CAPS) {
-        ndks_boot.bi_frame->untypedList[i] = (seL4_UntypedDesc) {
-            pptr_to_paddr((void*)pptr), 0, 0, size_bits, device_memory
-        };
-        ut_cap = cap_untyped_cap_new(MAX_FREE_INDEX(size_bits),
-                                     device_memory, size_bits, pptr);
-        ret = provide_cap(root_cnode_cap, ut_cap);
+        desc = &ndks_boot.bi_frame->untypedList[i];
+    } else if (ndks_boot.untyped_bi &&
+               i - CONFIG_MAX_NUM_BOOTINFO_UNTYPED_CAPS < ndks_boot.untyped_bi_max) {
+        desc = (seL4_UntypedDesc*)(ndks_boot.untyped_bi + 1) + (i - CONFIG_MAX_NUM_BOOTINFO_UNTYPED_CAPS);
     } else {
-        printf("Kernel init: Too many untyped regions for boot info\n");
-        ret = true;
+        desc = NULL;
+    }
+
+    /* Never fail the boot over an untyped we cannot describe, but make sure
+     * the root task can tell that memory is missing */
+    if (desc == NULL || ndks_boot.slot_pos_cur >= ndks_boot.slot_pos_max) {
+        printf("Kernel init: Too many untyped regions for boot info, dropping %s region at 0x%lx of 2^%lu bytes\n",
+               device_memory ? "device" : "RAM", (word_t)pptr_to_paddr((void*)pptr), size_bits);
+        ndks_boot.bi_frame->untypedDropped++;
+        return true;
+    }
+
+    if (i >= CONFIG_MAX_NUM_BOOTINFO_UNTYPED_CAPS) {
+        ndks_boot.untyped_bi->numUntypeds++;
     }
-    return ret;
+    *desc = (seL4_UntypedDesc) {
+        pptr_to_paddr((void*)pptr), numa_node, 0, size_bits, device_memory
+    };
+    ut_cap = cap_untyped_cap_new(MAX_FREE_INDEX(size_bits),
+                                 device_memory, size_bits, pptr);
+    return provide_cap(root_cnode_cap, ut_cap);
 }
 
 /** DONT_TRANSLATE */
@@ -529,20 +599,53 @@ BOOT_CODE static word_t boot_ctzl (word_t x)
     return ctzl(x);
 }
 
-BOOT_CODE bool_t
-create_untypeds_for_region(
+/* Return the NUMA node of the start of reg, and shrink reg so that it does
+ * not extend past memory of the same node */
+BOOT_CODE static word_t
+numa_node_of_region(region_t *reg)
+{
+    paddr_t start = pptr_to_paddr((void*)reg->start);
+    paddr_t end = pptr_to_paddr((void*)reg->end);
+    word_t node = 0;
+    word_t i;
+
+    for (i = 0; i < ndks_boot.num_numa_p_regs; i++) {
+        p_region_t numa_reg = ndks_boot.numa_p_regs[i].p_reg;
+        if (start >= numa_reg.start && start < numa_reg.end) {
+            node = ndks_boot.numa_p_regs[i].node;
+            end = MIN(end, numa_reg.end);
+        } else if (numa_reg.start > start) {
+            end = MIN(end, numa_reg.start);
+        }
+    }
+
+    reg->end = reg->start + (end - start);
+    return node;
+}
+
+/* Provide the untypeds that make up reg. If only_size_bits is non-zero only
+ * the untypeds of exactly that size are provided */
+BOOT_CODE static bool_t
+create_untypeds_of_size_for_region(
     cap_t      root_cnode_cap,
     bool_t     device_memory,
     region_t   reg,
+    word_t     only_size_bits,
     seL4_SlotPos first_untyped_slot
 )
 {
     word_t align_bits;
     word_t size_bits;
+    word_t numa_node;
+    region_t node_reg;
 
     while (!is_reg_empty(reg)) {
+        /* Never let an untyped span more than one NUMA node */
+        node_reg = reg;
+        numa_node = numa_node_of_region(&node_reg);
+
         /* Determine the maximum size of the region */
-        size_bits = seL4_WordBits - 1 - clzl(reg.end - reg.start);
+        size_bits = seL4_WordBits - 1 - clzl(node_reg.end - node_reg.start);
 
         /* Determine the alignment of the region */
         if (reg.start != 0) {
@@ -558,8 +661,9 @@ create_untypeds_for_region(
             size_bits = seL4_MaxUntypedBits;
         }
 
-        if (size_bits >= seL4_MinUntypedBits) {
-            if (!provide_untyped_cap(root_cnode_cap, device_memory, reg.start, size_bits, first_untyped_slot)) {
+        if (size_bits >= seL4_MinUntypedBits &&
+                (only_size_bits == 0 || size_bits == only_size_bits)) {
+            if (!provide_untyped_cap(root_cnode_cap, device_memory, reg.start, size_bits, numa_node, first_untyped_slot)) {
                 return false;
             }
         }
@@ -568,23 +672,40 @@ create_untypeds_for_region(
     return true;
 }
 
+BOOT_CODE bool_t
+create_untypeds_for_region(
+    cap_t      root_cnode_cap,
+    bool_t     device_memory,
+    region_t   reg,
+    seL4_SlotPos first_untyped_slot
+)
+{
+    return create_untypeds_of_size_for_region(root_cnode_cap, device_memory, reg, 0, first_untyped_slot);
+}
+
 BOOT_CODE bool_t
 create_kernel_untypeds(cap_t root_cnode_cap, region_t boot_mem_reuse_reg, seL4_SlotPos first_untyped_slot)
 {
     word_t     i;
-    region_t   reg;
+    word_t     size_bits;
+    region_t   regs[MAX_NUM_FREEMEM_REG + 1];
 
     /* if boot_mem_reuse_reg is not empty, we can create UT objs from boot code/data frames */
-    if (!create_untypeds_for_region(root_cnode_cap, false, boot_mem_reuse_reg, first_untyped_slot)) {
-        return false;
-    }
+    regs[0] = boot_mem_reuse_reg;
 
     /* convert remaining freemem into UT objects and provide the caps */
     for (i = 0; i < MAX_NUM_FREEMEM_REG; i++) {
-        reg = ndks_boot.freemem[i];
+        regs[i + 1] = ndks_boot.freemem[i];
         ndks_boot.freemem[i] = REG_EMPTY;
-        if (!create_untypeds_for_region(root_cnode_cap, false, reg, first_untyped_slot)) {
-            return false;
+    }
+
+    /* Provide the largest untypeds first, so that if the untypeds cannot all
+     * be described it is the small ones that are dropped */
+    for (size_bits = seL4_MaxUntypedBits; size_bits >= seL4_MinUntypedBits; size_bits--) {
+        for (i = 0; i < MAX_NUM_FREEMEM_REG + 1; i++) {
+            if (!create_untypeds_of_size_for_region(root_cnode_cap, false, regs[i], size_bits, first_untyped_slot)) {
+                return false;
+            }
         }
     }
 
@@ -61,6 +61,16 @@ lookupSlot(tcb_t *thread, cptr_t capptr)
     resolveAddressBits_ret_t res_ret;
     lookupSlot_raw_ret_t ret;
 
+#ifdef CONFIG_ASYNC_REVOKE
+    /* A CSpace whose root is queued for an asynchronous revoke is gone */
+    if (unlikely(mdb_node_get_mdbRevoking(TCB_PTR_CTE_PTR(thread, tcbCTable)->cteMDBNode))) {
+        current_lookup_fault = lookup_fault_invalid_root_new();
+        ret.status = EXCEPTION_LOOKUP_FAULT;
+        ret.slot = NULL;
+        return ret;
+    }
+#endif
+
     threadRoot = TCB_PTR_CTE_PTR(thread, tcbCTable)->cap;
     res_ret = resolveAddressBits(threadRoot, capptr, wordBits);
 
@@ -183,6 +193,16 @@ resolveAddressBits(cap_t nodeCap, cptr_t capptr, word_t n_bits)
         offset = (capptr >> (n_bits - levelBits)) & MASK(radixBits);
         slot = CTE_PTR(cap_cnode_cap_get_capCNodePtr(nodeCap)) + offset;
 
+#ifdef CONFIG_ASYNC_REVOKE
+        /* Capabilities queued for an asynchronous revoke can no longer be
+         * used, named as a target or traversed */
+        if (unlikely(mdb_node_get_mdbRevoking(slot->cteMDBNode))) {
+            current_lookup_fault = lookup_fault_missing_capability_new(n_bits);
+            ret.status = EXCEPTION_LOOKUP_FAULT;
+            return ret;
+        }
+#endif
+
         if (likely(n_bits <= levelBits)) {
             ret.status = EXCEPTION_NONE;
             ret.slot = slot;
@@ -17,6 +17,7 @@
 #include <kernel/thread.h>
 #include <kernel/vspace.h>
 #include <model/statedata.h>
+#include <model/kernel_stats.h>
 #include <arch/machine.h>
 #include <arch/kernel/thread.h>
 #include <machine/registerset.h>
@@ -24,7 +25,7 @@
 
 static seL4_MessageInfo_t
 transferCaps(seL4_MessageInfo_t info, extra_caps_t caps,
-             endpoint_t *endpoint, tcb_t *receiver,
+             endpoint_t *endpoint, tcb_t *sender, tcb_t *receiver,
              word_t *receiveBuffer);
 
 static inline bool_t PURE
@@ -36,6 +37,9 @@ isBlocked(const tcb_t *thread)
     case ThreadState_BlockedOnSend:
     case ThreadState_BlockedOnNotification:
     case ThreadState_BlockedOnReply:
+#ifdef CONFIG_KERNEL_TIMEOUTS
+    case ThreadState_BlockedOnTimeout:
+#endif
         return true;
 
     default:
@@ -121,6 +125,10 @@ doReplyTransfer(tcb_t *sender, tcb_t *receiver, cte_t *slot)
     assert(thread_state_get_tsType(receiver->tcbState) ==
            ThreadState_BlockedOnReply);
 
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    restorePriority(sender);
+#endif
+
     if (likely(seL4_Fault_get_seL4_FaultType(receiver->tcbFault) == seL4_Fault_NullFault)) {
         doIPCTransfer(sender, NULL, 0, true, receiver);
         /** GHOSTUPD: "(True, gs_set_assn cteDeleteOne_'proc (ucast cap_reply_cap))" */
@@ -169,7 +177,7 @@ doNormalTransfer(tcb_t *sender, word_t *sendBuffer, endpoint_t *endpoint,
     msgTransferred = copyMRs(sender, sendBuffer, receiver, receiveBuffer,
                              seL4_MessageInfo_get_length(tag));
 
-    tag = transferCaps(tag, caps, endpoint, receiver, receiveBuffer);
+    tag = transferCaps(tag, caps, endpoint, sender, receiver, receiveBuffer);
 
     tag = seL4_MessageInfo_set_length(tag, msgTransferred);
     setRegister(receiver, msgInfoRegister, wordFromMessageInfo(tag));
@@ -193,7 +201,7 @@ doFaultTransfer(word_t badge, tcb_t *sender, tcb_t *receiver,
 /* Like getReceiveSlots, this is specialised for single-cap transfer. */
 static seL4_MessageInfo_t
 transferCaps(seL4_MessageInfo_t info, extra_caps_t caps,
-             endpoint_t *endpoint, tcb_t *receiver,
+             endpoint_t *endpoint, tcb_t *sender, tcb_t *receiver,
              word_t *receiveBuffer)
 {
     word_t i;
@@ -229,6 +237,26 @@ transferCaps(seL4_MessageInfo_t info, extra_caps_t caps,
                 break;
             }
 
+#ifdef CONFIG_FRAME_DONATION
+            if (receiver->tcbDonationWindowPages && sender->tcbDonateFrames) {
+                /* A donated frame is moved rather than copied. A frame cap
+                 * is never unwrapped, so its unwrapped bit marks it as
+                 * donated and its badge holds the address it was mapped
+                 * at. */
+                donateFrame_ret_t df_ret;
+
+                df_ret = Arch_donateFrame(cap, receiver);
+                if (df_ret.donated) {
+                    cteMove(df_ret.cap, slot, destSlot);
+                    setExtraBadge(receiveBuffer, df_ret.vaddr, i);
+                    info = seL4_MessageInfo_set_capsUnwrapped(info,
+                                                              seL4_MessageInfo_get_capsUnwrapped(info) | (1 << i));
+                    destSlot = NULL;
+                    continue;
+                }
+            }
+#endif
+
             dc_ret = deriveCap(slot, cap);
 
             if (dc_ret.status != EXCEPTION_NONE) {
@@ -265,8 +293,8 @@ nextDomain(void)
     ksDomainTime = ksDomSchedule[ksDomScheduleIdx].length;
 }
 
-void
-schedule(void)
+static void
+scheduleAction(void)
 {
     word_t action;
 
@@ -288,6 +316,22 @@ schedule(void)
         switchToThread(NODE_STATE(ksSchedulerAction));
         NODE_STATE(ksSchedulerAction) = SchedulerAction_ResumeCurrentThread;
     }
+}
+
+void
+schedule(void)
+{
+    scheduleAction();
+
+    /* A pending asynchronous revoke uses idle time, and a slice of every
+     * other kernel exit. It may delete the chosen thread or wake the one
+     * waiting for it, so choose again afterwards. */
+#ifdef CONFIG_ASYNC_REVOKE
+    if (unlikely(isAsyncRevokePending())) {
+        drainAsyncRevoke(NODE_STATE(ksCurThread) == NODE_STATE(ksIdleThread));
+        scheduleAction();
+    }
+#endif
 
 #ifdef ENABLE_SMP_SUPPORT
     doMaskReschedule(ARCH_NODE_STATE(ipiReschedulePending));
@@ -324,6 +368,9 @@ chooseThread(void)
 void
 switchToThread(tcb_t *thread)
 {
+    if (thread != NODE_STATE(ksCurThread)) {
+        KERNEL_STATS_INC(seL4_KernelStats_ContextSwitches);
+    }
 #ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
     benchmark_utilisation_switch(NODE_STATE(ksCurThread), thread);
 #endif
@@ -335,6 +382,9 @@ switchToThread(tcb_t *thread)
 void
 switchToIdleThread(void)
 {
+    if (NODE_STATE(ksIdleThread) != NODE_STATE(ksCurThread)) {
+        KERNEL_STATS_INC(seL4_KernelStats_ContextSwitches);
+    }
 #ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
     benchmark_utilisation_switch(NODE_STATE(ksCurThread), NODE_STATE(ksIdleThread));
 #endif
@@ -374,6 +424,52 @@ setPriority(tcb_t *tptr, prio_t prio)
     }
 }
 
+#ifdef CONFIG_PRIORITY_INHERITANCE
+/* Raise a server that has opted in to the priority of a client that is
+ * waiting on it for a reply, but no higher than the server's MCP. Raising a
+ * thread never requires a reschedule, as anything it now outranks was
+ * already outranked by the client. */
+void
+inheritPriority(tcb_t *server, tcb_t *client)
+{
+    prio_t prio = MIN(client->tcbPriority, server->tcbMCP);
+
+    if (!server->tcbInheritPriority || prio <= server->tcbPriority) {
+        return;
+    }
+
+    if (!server->tcbBoosted) {
+        server->tcbBasePriority = server->tcbPriority;
+        server->tcbBoosted = true;
+    }
+
+    /* The current thread is not queued while it runs, and may be about to
+     * block, so as on the fastpath only its priority changes */
+    tcbSchedDequeue(server);
+    server->tcbPriority = prio;
+    if (isRunnable(server) && server != NODE_STATE(ksCurThread)) {
+        SCHED_ENQUEUE(server);
+    }
+}
+
+void
+restorePriority(tcb_t *tptr)
+{
+    if (unlikely(tptr->tcbBoosted)) {
+        tptr->tcbBoosted = false;
+        if (tptr == NODE_STATE(ksCurThread)) {
+            /* Callers are about to reply or block, so the current thread
+             * must not be queued here either */
+            tcbSchedDequeue(tptr);
+            tptr->tcbPriority = tptr->tcbBasePriority;
+            rescheduleRequired();
+        } else {
+            setPriority(tptr, tptr->tcbBasePriority);
+        }
+    }
+}
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+
 static void
 possibleSwitchTo(tcb_t* target, bool_t onSamePriority)
 {
@@ -418,6 +514,12 @@ switchIfRequiredTo(tcb_t* target)
 void
 setThreadState(tcb_t *tptr, _thread_state_t ts)
 {
+#ifdef CONFIG_KERNEL_TIMEOUTS
+    /* whatever ends a timed wait also disarms its timeout */
+    if (unlikely(tptr->tcbSleeping)) {
+        tcbSleepDequeue(tptr);
+    }
+#endif
     thread_state_ptr_set_tsType(&tptr->tcbState, ts);
     scheduleTCB(tptr);
 }
@@ -452,7 +554,36 @@ timerTick(void)
             rescheduleRequired();
         }
     }
+
+#ifdef CONFIG_KERNEL_TIMEOUTS
+    if (SMP_TERNARY(getCurrentCPUIndex(), 0) == 0) {
+        ksTicks++;
+    }
+
+    while (NODE_STATE(ksSleepQueue) &&
+            (sword_t)(NODE_STATE(ksSleepQueue)->tcbDeadline - ksTicks) <= 0) {
+        tcb_t *tptr = NODE_STATE(ksSleepQueue);
+
+        tcbSleepDequeue(tptr);
+        timeoutThread(tptr);
+        attemptSwitchTo(tptr);
+    }
+#endif
+}
+
+#ifdef CONFIG_KERNEL_TIMEOUTS
+void
+timeoutThread(tcb_t *tptr)
+{
+    /* Leaves the thread inactive, if it was waiting on an object */
+    cancelIPC(tptr);
+
+    setRegister(tptr, badgeRegister, ksTicks);
+    setRegister(tptr, msgInfoRegister, wordFromMessageInfo(
+                    seL4_MessageInfo_new(0, 0, 0, seL4_TimeoutMsgLength)));
+    setThreadState(tptr, ThreadState_Running);
 }
+#endif /* CONFIG_KERNEL_TIMEOUTS */
 
 void
 rescheduleRequired(void)
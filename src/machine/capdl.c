@@ -0,0 +1,449 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the GNU General Public License version 2. Note that NO WARRANTY is provided.
+ * See "LICENSE_GPLv2.txt" for details.
+ *
+ * @TAG(DATA61_GPL)
+ */
+
+#include <config.h>
+
+#ifdef CONFIG_DEBUG_BUILD
+
+#include <types.h>
+#include <api/failures.h>
+#include <kernel/cspace.h>
+#include <model/statedata.h>
+#include <model/preemption.h>
+#include <object/structures.h>
+#include <machine/io.h>
+#include <machine/capdl.h>
+#include <arch/machine/capdl.h>
+
+/* Binary capDL snapshots.
+ *
+ * The image is an array of fixed size records, written into a set of frames
+ * supplied by the caller. The frames are only ever written: everything the
+ * snapshot needs to continue, including the work list of CNodes still to be
+ * expanded and the set of CNodes already discovered, is kept in kernel
+ * memory. The slots of each TCB are expanded as the TCB is recorded, and the
+ * IRQ node seeds the work list. Further CNodes are discovered through the
+ * cnode caps in slots already expanded. */
+
+word_t ksCapDLObjectsDestroyed;
+
+/* Number of CNodes, not counting the CNodes of TCBs, a snapshot can hold */
+#define CAPDL_SNAPSHOT_MAX_CNODES 512
+#define CAPDL_SNAPSHOT_TABLE_BITS 10
+
+compile_assert(capdl_snapshot_table_size,
+               CAPDL_SNAPSHOT_MAX_CNODES < BIT(CAPDL_SNAPSHOT_TABLE_BITS))
+
+typedef enum {
+    SnapshotPhase_TCBs,
+    SnapshotPhase_CNodes
+} snapshot_phase_t;
+
+typedef struct snapshot_cnode {
+    cte_t *slots;
+    word_t numSlots;
+} snapshot_cnode_t;
+
+/* State of a snapshot in progress. The snapshot holds pointers to CNodes
+ * and TCBs across preemption, so it is only continued if none has been
+ * destroyed in the meantime. Caps to the frames of the image may change while
+ * the snapshot is preempted, so the frame cache only lives for one kernel
+ * entry. */
+typedef struct snapshot {
+    tcb_t *thread;
+    cptr_t frames;
+    word_t numFrames;
+    word_t frameBits;
+    word_t objectsDestroyed;
+    word_t phase;
+    word_t maxRecords;
+    word_t numRecords;
+    word_t node;
+    tcb_t *tcb;
+    word_t index;
+    word_t slot;
+    /* the last two frames looked up, indexed by frame number & 1 */
+    word_t cachedFrame[2];
+    word_t cachedBase[2];
+    /* the work list, in order of discovery */
+    word_t numCNodes;
+    snapshot_cnode_t cnodes[CAPDL_SNAPSHOT_MAX_CNODES];
+    /* open addressed hash set of the discovered CNodes, each entry is one
+     * more than the CNode's index in the work list, or 0 if unused */
+    uint16_t table[BIT(CAPDL_SNAPSHOT_TABLE_BITS)];
+} snapshot_t;
+
+/* each node has its own snapshot in progress */
+static snapshot_t snapshots[CONFIG_MAX_NUM_NODES];
+
+static inline snapshot_t *
+currentSnapshot(void)
+{
+    return &snapshots[SMP_TERNARY(getCurrentCPUIndex(), 0)];
+}
+
+static word_t *
+snapshotWordPtr(snapshot_t *snapshot, word_t offset)
+{
+    word_t frame = offset >> snapshot->frameBits;
+    word_t way = frame & 1;
+    lookupCap_ret_t lu_ret;
+
+    assert(frame < snapshot->numFrames);
+    if (likely(snapshot->cachedFrame[way] == frame)) {
+        return (word_t *)(snapshot->cachedBase[way] + (offset & MASK(snapshot->frameBits)));
+    }
+
+    lu_ret = lookupCap(snapshot->thread, snapshot->frames + frame);
+    if (unlikely(lu_ret.status != EXCEPTION_NONE ||
+                 !Arch_isCapDLSnapshotFrame(lu_ret.cap) ||
+                 cap_get_capSizeBits(lu_ret.cap) != snapshot->frameBits)) {
+        userError("CapDL snapshot: slot %lu is not a frame of the image.",
+                  (unsigned long)(snapshot->frames + frame));
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 0;
+        return NULL;
+    }
+
+    snapshot->cachedFrame[way] = frame;
+    snapshot->cachedBase[way] = (word_t)cap_get_capPtr(lu_ret.cap);
+
+    return (word_t *)(snapshot->cachedBase[way] + (offset & MASK(snapshot->frameBits)));
+}
+
+static seL4_CapDLSnapshotRecord_t *
+snapshotRecord(snapshot_t *snapshot, word_t index)
+{
+    return (seL4_CapDLSnapshotRecord_t *)snapshotWordPtr(snapshot, index * sizeof(seL4_CapDLSnapshotRecord_t));
+}
+
+static seL4_CapDLSnapshotRecord_t *
+snapshotNewRecord(snapshot_t *snapshot, word_t type, word_t object, word_t index)
+{
+    seL4_CapDLSnapshotRecord_t *record;
+
+    if (unlikely(snapshot->numRecords >= snapshot->maxRecords)) {
+        userError("CapDL snapshot: image does not fit in %lu frames.",
+                  (unsigned long)snapshot->numFrames);
+        current_syscall_error.type = seL4_NotEnoughMemory;
+        current_syscall_error.memoryLeft = 0;
+        return NULL;
+    }
+
+    record = snapshotRecord(snapshot, snapshot->numRecords);
+    if (unlikely(record == NULL)) {
+        return NULL;
+    }
+    snapshot->numRecords++;
+
+    record->type = type;
+    record->object = object;
+    record->index = index;
+    record->data[0] = 0;
+    record->data[1] = 0;
+    record->data[2] = 0;
+    record->data[3] = 0;
+    record->data[4] = 0;
+
+    return record;
+}
+
+/* Add a CNode to the work list and the image, unless it is already there */
+static exception_t
+snapshotDiscoverCNode(snapshot_t *snapshot, cte_t *cnode, word_t numSlots)
+{
+    word_t hash = ((word_t)cnode >> seL4_SlotBits) * 0x9e3779b1ul;
+    word_t i, probe, entry;
+
+    for (i = 0; i < BIT(CAPDL_SNAPSHOT_TABLE_BITS); i++) {
+        probe = (hash + i) & MASK(CAPDL_SNAPSHOT_TABLE_BITS);
+        entry = snapshot->table[probe];
+        if (entry == 0) {
+            break;
+        }
+        if (snapshot->cnodes[entry - 1].slots == cnode) {
+            return EXCEPTION_NONE;
+        }
+    }
+
+    if (unlikely(snapshot->numCNodes >= CAPDL_SNAPSHOT_MAX_CNODES)) {
+        userError("CapDL snapshot: more than %d CNodes.", CAPDL_SNAPSHOT_MAX_CNODES);
+        current_syscall_error.type = seL4_NotEnoughMemory;
+        current_syscall_error.memoryLeft = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (unlikely(snapshotNewRecord(snapshot, seL4_CapDLSnapshot_CNode, (word_t)cnode, numSlots) == NULL)) {
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    snapshot->cnodes[snapshot->numCNodes].slots = cnode;
+    snapshot->cnodes[snapshot->numCNodes].numSlots = numSlots;
+    snapshot->numCNodes++;
+    /* there are fewer CNodes than table entries, so the probe above always
+     * ends at an unused entry */
+    snapshot->table[probe] = snapshot->numCNodes;
+
+    return EXCEPTION_NONE;
+}
+
+/* Record the slots of a CNode from snapshot->slot onwards */
+static exception_t
+snapshotExpandCNode(snapshot_t *snapshot, cte_t *cnode, word_t numSlots)
+{
+    seL4_CapDLSnapshotRecord_t *record;
+    exception_t status;
+    cte_t *slot;
+
+    while (snapshot->slot < numSlots) {
+        slot = cnode + snapshot->slot;
+
+        if (cap_get_capType(slot->cap) != cap_null_cap) {
+            record = snapshotNewRecord(snapshot, seL4_CapDLSnapshot_Slot, (word_t)cnode, snapshot->slot);
+            if (unlikely(record == NULL)) {
+                return EXCEPTION_SYSCALL_ERROR;
+            }
+            record->data[0] = slot->cap.words[0];
+            record->data[1] = slot->cap.words[1];
+            record->data[2] = slot->cteMDBNode.words[0];
+            record->data[3] = slot->cteMDBNode.words[1];
+
+            if (cap_get_capType(slot->cap) == cap_cnode_cap) {
+                status = snapshotDiscoverCNode(snapshot, CTE_PTR(cap_cnode_cap_get_capCNodePtr(slot->cap)),
+                                               BIT(cap_cnode_cap_get_capCNodeRadix(slot->cap)));
+                if (unlikely(status != EXCEPTION_NONE)) {
+                    return status;
+                }
+            }
+        }
+        snapshot->slot++;
+
+        status = preemptionPoint();
+        if (unlikely(status != EXCEPTION_NONE)) {
+            return status;
+        }
+    }
+
+    return EXCEPTION_NONE;
+}
+
+static exception_t
+snapshotStart(snapshot_t *snapshot, cptr_t frames, word_t numFrames)
+{
+    lookupCap_ret_t lu_ret;
+    word_t frameBits, i;
+
+    lu_ret = lookupCap(NODE_STATE(ksCurThread), frames);
+    if (unlikely(lu_ret.status != EXCEPTION_NONE ||
+                 !Arch_isCapDLSnapshotFrame(lu_ret.cap))) {
+        userError("CapDL snapshot: first cap is not a frame.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+    frameBits = cap_get_capSizeBits(lu_ret.cap);
+
+    if (unlikely(numFrames == 0 || numFrames > MASK(wordBits - 1 - frameBits))) {
+        userError("CapDL snapshot: invalid number of frames %lu.", (unsigned long)numFrames);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 1;
+        current_syscall_error.rangeErrorMax = MASK(wordBits - 1 - frameBits);
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* a snapshot the thread left preempted on another node must not be
+     * continued after this one has written over the image */
+    for (i = 0; i < ksNumCPUs; i++) {
+        if (snapshots[i].thread == NODE_STATE(ksCurThread)) {
+            snapshots[i].thread = NULL;
+        }
+    }
+
+    snapshot->thread = NODE_STATE(ksCurThread);
+    snapshot->frames = frames;
+    snapshot->numFrames = numFrames;
+    snapshot->frameBits = frameBits;
+    snapshot->objectsDestroyed = ksCapDLObjectsDestroyed;
+    snapshot->phase = SnapshotPhase_TCBs;
+    snapshot->maxRecords = (numFrames << frameBits) / sizeof(seL4_CapDLSnapshotRecord_t);
+    /* record 0 is the header, which is written last */
+    snapshot->numRecords = 1;
+    snapshot->node = 0;
+    snapshot->tcb = NODE_STATE_ON_CORE(ksDebugTCBs, 0);
+    snapshot->index = 0;
+    snapshot->slot = 0;
+    snapshot->numCNodes = 0;
+    memzero(snapshot->table, sizeof(snapshot->table));
+
+    return EXCEPTION_NONE;
+}
+
+static exception_t
+snapshotRunQueues(snapshot_t *snapshot, word_t node)
+{
+    seL4_CapDLSnapshotRecord_t *record;
+    tcb_t *tcb;
+    word_t i, position;
+
+    record = snapshotNewRecord(snapshot, seL4_CapDLSnapshot_RunQueue, node, 0);
+    if (unlikely(record == NULL)) {
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+    record->data[0] = (word_t)NODE_STATE_ON_CORE(ksCurThread, node);
+
+    position = 1;
+    for (i = 0; i < NUM_READY_QUEUES; i++) {
+        for (tcb = NODE_STATE_ON_CORE(ksReadyQueues[i], node).head; tcb != NULL; tcb = tcb->tcbSchedNext) {
+            record = snapshotNewRecord(snapshot, seL4_CapDLSnapshot_RunQueue, node, position);
+            if (unlikely(record == NULL)) {
+                return EXCEPTION_SYSCALL_ERROR;
+            }
+            record->data[0] = (word_t)tcb;
+            position++;
+        }
+    }
+
+    return EXCEPTION_NONE;
+}
+
+static exception_t
+snapshotTCBs(snapshot_t *snapshot)
+{
+    seL4_CapDLSnapshotRecord_t *record;
+    exception_t status;
+    tcb_t *tcb;
+
+    while (snapshot->node < ksNumCPUs) {
+        while (snapshot->tcb != NULL) {
+            tcb = snapshot->tcb;
+
+            /* a preempted snapshot continues part way through the slots of
+             * a TCB it has already recorded */
+            if (snapshot->slot == 0) {
+                record = snapshotNewRecord(snapshot, seL4_CapDLSnapshot_TCB, (word_t)tcb, snapshot->node);
+                if (unlikely(record == NULL)) {
+                    return EXCEPTION_SYSCALL_ERROR;
+                }
+                record->data[0] = thread_state_get_tsType(tcb->tcbState);
+                record->data[1] = tcb->tcbPriority;
+                record->data[2] = (word_t)tcb->tcbBoundNotification;
+                record->data[3] = (word_t)TCB_PTR_CTE_PTR(tcb, 0);
+
+                /* the slots of a TCB are only reachable from its TCB record */
+                if (unlikely(snapshotNewRecord(snapshot, seL4_CapDLSnapshot_CNode,
+                                               (word_t)TCB_PTR_CTE_PTR(tcb, 0), tcbCNodeEntries) == NULL)) {
+                    return EXCEPTION_SYSCALL_ERROR;
+                }
+            }
+
+            status = snapshotExpandCNode(snapshot, TCB_PTR_CTE_PTR(tcb, 0), tcbCNodeEntries);
+            if (unlikely(status != EXCEPTION_NONE)) {
+                return status;
+            }
+            snapshot->tcb = tcb->tcbDebugNext;
+            snapshot->slot = 0;
+        }
+
+        status = snapshotRunQueues(snapshot, snapshot->node);
+        if (unlikely(status != EXCEPTION_NONE)) {
+            return status;
+        }
+
+        snapshot->node++;
+        if (snapshot->node < ksNumCPUs) {
+            snapshot->tcb = NODE_STATE_ON_CORE(ksDebugTCBs, snapshot->node);
+        }
+    }
+
+    return snapshotDiscoverCNode(snapshot, intStateIRQNode, maxIRQ + 1);
+}
+
+static exception_t
+snapshotCNodes(snapshot_t *snapshot)
+{
+    exception_t status;
+
+    while (snapshot->index < snapshot->numCNodes) {
+        status = snapshotExpandCNode(snapshot, snapshot->cnodes[snapshot->index].slots,
+                                     snapshot->cnodes[snapshot->index].numSlots);
+        if (unlikely(status != EXCEPTION_NONE)) {
+            return status;
+        }
+
+        snapshot->index++;
+        snapshot->slot = 0;
+    }
+
+    return EXCEPTION_NONE;
+}
+
+exception_t
+capDL_snapshot(cptr_t frames, word_t numFrames)
+{
+    snapshot_t *snapshot = currentSnapshot();
+    seL4_CapDLSnapshotRecord_t *header;
+    exception_t status;
+
+    snapshot->cachedFrame[0] = -1;
+    snapshot->cachedFrame[1] = -1;
+
+    if (snapshot->thread != NODE_STATE(ksCurThread) || snapshot->frames != frames ||
+            snapshot->numFrames != numFrames || snapshot->objectsDestroyed != ksCapDLObjectsDestroyed) {
+        status = snapshotStart(snapshot, frames, numFrames);
+        if (unlikely(status != EXCEPTION_NONE)) {
+            return status;
+        }
+    }
+
+    if (snapshot->phase == SnapshotPhase_TCBs) {
+        status = snapshotTCBs(snapshot);
+        if (unlikely(status != EXCEPTION_NONE)) {
+            goto out;
+        }
+        snapshot->phase = SnapshotPhase_CNodes;
+        snapshot->index = 0;
+        snapshot->slot = 0;
+    }
+
+    status = snapshotCNodes(snapshot);
+    if (unlikely(status != EXCEPTION_NONE)) {
+        goto out;
+    }
+
+    header = snapshotRecord(snapshot, 0);
+    if (unlikely(header == NULL)) {
+        status = EXCEPTION_SYSCALL_ERROR;
+        goto out;
+    }
+    header->type = seL4_CapDLSnapshot_Header;
+    header->object = sizeof(cte_t);
+    header->index = snapshot->numRecords;
+    header->data[0] = seL4_CapDLSnapshotMagic;
+    header->data[1] = seL4_CapDLSnapshotVersion;
+    header->data[2] = ksNumCPUs;
+    header->data[3] = 0;
+    header->data[4] = 0;
+
+out:
+    if (status != EXCEPTION_PREEMPTED) {
+        snapshot->thread = NULL;
+    }
+    return status;
+}
+
+word_t
+capDL_snapshotSize(void)
+{
+    return currentSnapshot()->numRecords * sizeof(seL4_CapDLSnapshotRecord_t);
+}
+
+#endif /* CONFIG_DEBUG_BUILD */
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2017, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the GNU General Public License version 2. Note that NO WARRANTY is provided.
+ * See "LICENSE_GPLv2.txt" for details.
+ *
+ * @TAG(DATA61_GPL)
+ */
+
+#include <config.h>
+
+#ifdef CONFIG_KERNEL_STATS
+
+#include <types.h>
+#include <api/failures.h>
+#include <api/shared_types.h>
+#include <kernel/vspace.h>
+#include <model/statedata.h>
+#include <model/smp.h>
+#include <model/kernel_stats.h>
+
+exception_t
+kernelStats_dump(word_t node, word_t firstIRQ)
+{
+    seL4_IPCBuffer *buffer;
+    word_t i;
+
+    if (node >= ksNumCPUs) {
+        userError("KernelStats: Invalid node %lu.", node);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = ksNumCPUs - 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (firstIRQ > maxIRQ + 1) {
+        userError("KernelStats: Invalid first IRQ %lu.", firstIRQ);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = maxIRQ + 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    buffer = (seL4_IPCBuffer *)lookupIPCBuffer(true, NODE_STATE(ksCurThread));
+    if (!buffer) {
+        userError("KernelStats: Failed to lookup IPC buffer.");
+        current_syscall_error.type = seL4_IllegalOperation;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* Counters of a remote node may be mid update, but each is a single
+     * word so a reader always sees some recent value */
+    for (i = 0; i < seL4_KernelStats_IRQs; i++) {
+        buffer->msg[i] = NODE_STATE_ON_CORE(ksKernelStats, node)[i];
+    }
+
+    for (i = 0; i < seL4_MsgMaxLength - seL4_KernelStats_IRQs &&
+            firstIRQ + i <= maxIRQ; i++) {
+        buffer->msg[seL4_KernelStats_IRQs + i] =
+            NODE_STATE_ON_CORE(ksKernelStatsIRQs, node)[firstIRQ + i];
+    }
+
+    /* Number of IRQ counts written */
+    setRegister(NODE_STATE(ksCurThread), msgInfoRegister, i);
+    return EXCEPTION_NONE;
+}
+
+#endif /* CONFIG_KERNEL_STATS */
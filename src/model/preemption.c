@@ -11,6 +11,7 @@
 #include <api/failures.h>
 #include <model/preemption.h>
 #include <model/statedata.h>
+#include <model/kernel_stats.h>
 #include <plat/machine/hardware.h>
 #include <config.h>
 
@@ -22,6 +23,9 @@ preemptionPoint(void)
 {
     /* Record that we have performed some work. */
     ksWorkUnitsCompleted++;
+#ifdef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG
+    NODE_STATE(ksWatchdogPreemptionPoints)++;
+#endif
 
     /*
      * If we have performed a non-trivial amount of work since last time we
@@ -34,8 +38,14 @@ preemptionPoint(void)
     if (ksWorkUnitsCompleted >= CONFIG_MAX_NUM_WORK_UNITS_PER_PREEMPTION) {
         ksWorkUnitsCompleted = 0;
         if (isIRQPending()) {
+            KERNEL_STATS_INC(seL4_KernelStats_Preemptions);
             return EXCEPTION_PREEMPTED;
         }
+#ifdef CONFIG_ASYNC_REVOKE
+        if (ksAsyncRevokeSlice) {
+            return EXCEPTION_PREEMPTED;
+        }
+#endif
     }
 
     return EXCEPTION_NONE;
@@ -24,6 +24,16 @@ SMP_STATE_DEFINE(smpStatedata_t, ksSMP[CONFIG_MAX_NUM_NODES] ALIGN(L1_CACHE_LINE
 /* Global count of how many cpus there are */
 word_t ksNumCPUs;
 
+#ifdef CONFIG_KERNEL_TIMEOUTS
+/* Timer ticks since boot, counted by the boot core */
+word_t ksTicks;
+#endif
+
+#ifdef CONFIG_THREAD_REGISTRY
+/* Head of the list of all tcbs, across all cores */
+tcb_t *ksThreadRegistry;
+#endif
+
 /* Pointer to the head of the scheduler queue for each priority */
 UP_STATE_DEFINE(tcb_queue_t, ksReadyQueues[NUM_READY_QUEUES]);
 UP_STATE_DEFINE(word_t, ksReadyQueuesL1Bitmap[CONFIG_NUM_DOMAINS]);
@@ -52,10 +62,54 @@ UP_STATE_DEFINE(word_t, ksFPURestoresSinceSwitch);
 UP_STATE_DEFINE(tcb_t *, ksDebugTCBs);
 #endif /* CONFIG_DEBUG_BUILD */
 
+#ifdef CONFIG_KERNEL_TIMEOUTS
+UP_STATE_DEFINE(tcb_t *, ksSleepQueue);
+#endif /* CONFIG_KERNEL_TIMEOUTS */
+
+#ifdef CONFIG_KERNEL_STATS
+/* Per core statistics counters, and per core counts of each IRQ */
+UP_STATE_DEFINE(word_t, ksKernelStats[seL4_KernelStats_IRQs]);
+UP_STATE_DEFINE(word_t, ksKernelStatsIRQs[maxIRQ + 1]);
+#endif /* CONFIG_KERNEL_STATS */
+
+#ifdef CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG
+UP_STATE_DEFINE(benchmark_watchdog_entry_t, ksWatchdogLog[CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG_ENTRIES]);
+UP_STATE_DEFINE(word_t, ksWatchdogLogIndex);
+UP_STATE_DEFINE(benchmark_watchdog_entry_t, ksWatchdogMax[BENCHMARK_WATCHDOG_MAX_ENTRIES]);
+UP_STATE_DEFINE(tcb_t *, ksWatchdogEntryThread);
+UP_STATE_DEFINE(word_t, ksWatchdogPreemptionPoints);
+#endif /* CONFIG_BENCHMARK_KERNEL_ENTRY_WATCHDOG */
+
+#if defined(CONFIG_THREAD_REGISTRY) && defined(CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES)
+UP_STATE_DEFINE(uint64_t, ksKernelEntryTag);
+#endif
+
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+UP_STATE_DEFINE(tcb_t *, ksBenchmarkEntryThread);
+UP_STATE_DEFINE(word_t, ksBenchmarkEntryCause);
+UP_STATE_DEFINE(timestamp_t, ksBenchmarkExitTime);
+#endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
+
 /* Units of work we have completed since the last time we checked for
  * pending interrupts */
 word_t ksWorkUnitsCompleted;
 
+#ifdef CONFIG_MULTICAST
+/* Stamp given to the next thread queued to receive on an endpoint */
+word_t ksRecvStamp;
+#endif
+
+#ifdef CONFIG_ASYNC_REVOKE
+/* Kernel-held copies of the untyped being revoked in the background and of
+ * the notification to signal once that is done */
+cte_t ksAsyncRevokeUntyped ALIGN(BIT(seL4_SlotBits));
+cte_t ksAsyncRevokeNotification ALIGN(BIT(seL4_SlotBits));
+
+/* Set while a slice of the background revoke runs on a busy kernel entry,
+ * ending the slice at the next preemption check */
+bool_t ksAsyncRevokeSlice;
+#endif /* CONFIG_ASYNC_REVOKE */
+
 /* CNode containing interrupt handler endpoints */
 irq_state_t intStateIRQTable[maxIRQ + 1];
 cte_t *intStateIRQNode;
@@ -15,10 +15,13 @@
 #include <api/syscall.h>
 #include <api/types.h>
 #include <machine/io.h>
+#include <machine/capdl.h>
 #include <object/structures.h>
 #include <object/objecttype.h>
 #include <object/cnode.h>
 #include <object/interrupt.h>
+#include <object/notification.h>
+#include <object/tcb.h>
 #include <object/untyped.h>
 #include <kernel/cspace.h>
 #include <kernel/thread.h>
@@ -37,6 +40,15 @@ static finaliseSlot_ret_t finaliseSlot(cte_t *slot, bool_t exposed);
 static void emptySlot(cte_t *slot, irq_t irq);
 static exception_t reduceZombie(cte_t* slot, bool_t exposed);
 
+#ifdef CONFIG_ASYNC_REVOKE
+/* The thread marking the children of the pending asynchronous revoke, and
+ * the slot it is revoking, so that restarting it resumes the marking */
+static struct {
+    tcb_t *thread;
+    cte_t *slot;
+} asyncRevokeMarking;
+#endif
+
 exception_t
 decodeCNodeInvocation(word_t invLabel, word_t length, cap_t cap,
                       extra_caps_t excaps, word_t *buffer)
@@ -49,7 +61,15 @@ decodeCNodeInvocation(word_t invLabel, word_t length, cap_t cap,
     /* Haskell error: "decodeCNodeInvocation: invalid cap" */
     assert(cap_get_capType(cap) == cap_cnode_cap);
 
-    if (invLabel < CNodeRevoke || invLabel > CNodeSaveCaller) {
+    if (invLabel == CNodeSaveRegisters || invLabel == CNodeRestoreRegisters) {
+        return decodeCNodeRegisters(invLabel, length, cap, excaps, buffer);
+    }
+
+    if ((invLabel < CNodeRevoke || invLabel > CNodeSaveCaller)
+#ifdef CONFIG_ASYNC_REVOKE
+            && invLabel != CNodeRevokeAsync
+#endif
+       ) {
         userError("CNodeCap: Illegal Operation attempted.");
         current_syscall_error.type = seL4_IllegalOperation;
         return EXCEPTION_SYSCALL_ERROR;
@@ -201,6 +221,44 @@ decodeCNodeInvocation(word_t invLabel, word_t length, cap_t cap,
         return invokeCNodeDelete(destSlot);
     }
 
+#ifdef CONFIG_ASYNC_REVOKE
+    if (invLabel == CNodeRevokeAsync) {
+        cap_t ntfnCap;
+
+        if (excaps.excaprefs[0] == NULL) {
+            userError("CNode RevokeAsync: Truncated message.");
+            current_syscall_error.type = seL4_TruncatedMessage;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        if (cap_get_capType(destSlot->cap) != cap_untyped_cap) {
+            userError("CNode RevokeAsync: Target is not an untyped capability.");
+            current_syscall_error.type = seL4_IllegalOperation;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        ntfnCap = excaps.excaprefs[0]->cap;
+        if (cap_get_capType(ntfnCap) != cap_notification_cap ||
+                !cap_notification_cap_get_capNtfnCanSend(ntfnCap)) {
+            userError("CNode RevokeAsync: Notification cap invalid.");
+            current_syscall_error.type = seL4_InvalidCapability;
+            current_syscall_error.invalidCapNumber = 1;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        if (isAsyncRevokePending() &&
+                (asyncRevokeMarking.thread != NODE_STATE(ksCurThread) ||
+                 asyncRevokeMarking.slot != destSlot)) {
+            userError("CNode RevokeAsync: An asynchronous revoke is already pending.");
+            current_syscall_error.type = seL4_IllegalOperation;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+        return invokeCNodeRevokeAsync(destSlot, excaps.excaprefs[0]);
+    }
+#endif
+
     if (invLabel == CNodeSaveCaller) {
         status = ensureEmptySlot(destSlot);
         if (status != EXCEPTION_NONE) {
@@ -315,6 +373,46 @@ invokeCNodeRevoke(cte_t *destSlot)
     return cteRevoke(destSlot);
 }
 
+#ifdef CONFIG_ASYNC_REVOKE
+exception_t
+invokeCNodeRevokeAsync(cte_t *destSlot, cte_t *ntfnSlot)
+{
+    cte_t *nextPtr;
+    exception_t status;
+
+    /* Claim the revoke before the preemptible marking, so that any other
+     * caller is refused before it marks anything. The kernel's copy of the
+     * untyped sits between destSlot and the children, so it becomes their
+     * parent and destSlot has a child until the revoke is done. */
+    if (asyncRevokeMarking.thread != NODE_STATE(ksCurThread) ||
+            asyncRevokeMarking.slot != destSlot) {
+        cteInsert(destSlot->cap, destSlot, &ksAsyncRevokeUntyped);
+        cteInsert(ntfnSlot->cap, ntfnSlot, &ksAsyncRevokeNotification);
+        asyncRevokeMarking.thread = NODE_STATE(ksCurThread);
+        asyncRevokeMarking.slot = destSlot;
+    }
+
+    /* Mark every child so that lookups refuse it from now on. A preempted
+     * pass starts again from the top, and finds nothing left to mark if
+     * the revoke completed in the meantime. */
+    for (nextPtr = CTE_PTR(mdb_node_get_mdbNext(ksAsyncRevokeUntyped.cteMDBNode));
+            nextPtr && isMDBParentOf(&ksAsyncRevokeUntyped, nextPtr);
+            nextPtr = CTE_PTR(mdb_node_get_mdbNext(nextPtr->cteMDBNode))) {
+        mdb_node_ptr_set_mdbRevoking(&nextPtr->cteMDBNode, true);
+
+        status = preemptionPoint();
+        if (status != EXCEPTION_NONE) {
+            return status;
+        }
+    }
+
+    asyncRevokeMarking.thread = NULL;
+    asyncRevokeMarking.slot = NULL;
+
+    return EXCEPTION_NONE;
+}
+#endif /* CONFIG_ASYNC_REVOKE */
+
 exception_t
 invokeCNodeDelete(cte_t *destSlot)
 {
@@ -449,6 +547,7 @@ cteInsert(cap_t newCap, cte_t *srcSlot, cte_t *destSlot)
     newMDB = mdb_node_set_mdbPrev(srcMDB, CTE_REF(srcSlot));
     newMDB = mdb_node_set_mdbRevocable(newMDB, newCapIsRevocable);
     newMDB = mdb_node_set_mdbFirstBadged(newMDB, newCapIsRevocable);
+    newMDB = mdb_node_set_mdbRevoking(newMDB, false);
 
     /* Haskell error: "cteInsert to non-empty destination" */
     assert(cap_get_capType(destSlot->cap) == cap_null_cap);
@@ -581,6 +680,48 @@ cteRevoke(cte_t *slot)
     return EXCEPTION_NONE;
 }
 
+#ifdef CONFIG_ASYNC_REVOKE
+bool_t
+isAsyncRevokePending(void)
+{
+    return cap_get_capType(ksAsyncRevokeUntyped.cap) != cap_null_cap ||
+           cap_get_capType(ksAsyncRevokeNotification.cap) != cap_null_cap;
+}
+
+/* Continues the pending asynchronous revoke. When the kernel is idle it runs
+ * until an interrupt is pending, otherwise for at most one preemption
+ * interval. Signals the notification once the last child is gone. */
+void
+drainAsyncRevoke(bool_t idle)
+{
+    cap_t ntfnCap;
+    exception_t status;
+
+    ksWorkUnitsCompleted = 0;
+    ksAsyncRevokeSlice = !idle;
+    status = cteRevoke(&ksAsyncRevokeUntyped);
+    ksAsyncRevokeSlice = false;
+    if (status != EXCEPTION_NONE) {
+        return;
+    }
+
+    cteDeleteOne(&ksAsyncRevokeUntyped);
+
+    ntfnCap = ksAsyncRevokeNotification.cap;
+    if (cap_get_capType(ntfnCap) == cap_notification_cap) {
+        sendSignal(NTFN_PTR(cap_notification_cap_get_capNtfnPtr(ntfnCap)),
+                   cap_notification_cap_get_capNtfnBadge(ntfnCap));
+        cteDeleteOne(&ksAsyncRevokeNotification);
+    }
+
+    /* The marking thread may have been suspended or redirected before it
+     * finished. Restarting it now starts a new revoke rather than resuming
+     * this one, which no longer exists. */
+    asyncRevokeMarking.thread = NULL;
+    asyncRevokeMarking.slot = NULL;
+}
+#endif /* CONFIG_ASYNC_REVOKE */
+
 exception_t
 cteDelete(cte_t *slot, bool_t exposed)
 {
@@ -604,6 +745,13 @@ emptySlot(cte_t *slot, irq_t irq)
         mdb_node_t mdbNode;
         cte_t *prev, *next;
 
+#ifdef CONFIG_DEBUG_BUILD
+        /* emptying a Zombie is the last step in destroying a CNode or TCB */
+        if (cap_get_capType(slot->cap) == cap_zombie_cap) {
+            ksCapDLObjectsDestroyed++;
+        }
+#endif
+
         mdbNode = slot->cteMDBNode;
         prev = CTE_PTR(mdb_node_get_mdbPrev(mdbNode));
         next = CTE_PTR(mdb_node_get_mdbNext(mdbNode));
@@ -790,7 +938,7 @@ insertNewCap(cte_t *parent, cte_t *slot, cap_t cap)
 
     next = CTE_PTR(mdb_node_get_mdbNext(parent->cteMDBNode));
     slot->cap = cap;
-    slot->cteMDBNode = mdb_node_new(CTE_REF(next), true, true, CTE_REF(parent));
+    slot->cteMDBNode = mdb_node_new(CTE_REF(next), true, true, CTE_REF(parent), false);
     if (next) {
         mdb_node_ptr_set_mdbPrev(&next->cteMDBNode, CTE_REF(slot));
     }
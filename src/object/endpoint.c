@@ -13,6 +13,7 @@
 #include <kernel/vspace.h>
 #include <machine/registerset.h>
 #include <model/statedata.h>
+#include <model/preemption.h>
 #include <object/notification.h>
 #include <object/cnode.h>
 #include <object/endpoint.h>
@@ -90,6 +91,13 @@ sendIPC(bool_t blocking, bool_t do_call, word_t badge,
         /* Do the transfer */
         doIPCTransfer(thread, epptr, badge, canGrant, dest);
 
+#ifdef CONFIG_PRIORITY_INHERITANCE
+        if (canGrant && (do_call ||
+                         seL4_Fault_ptr_get_seL4_FaultType(&thread->tcbFault) != seL4_Fault_NullFault)) {
+            inheritPriority(dest, thread);
+        }
+#endif
+
         setThreadState(dest, ThreadState_Running);
         attemptSwitchTo(dest);
 
@@ -107,6 +115,78 @@ sendIPC(bool_t blocking, bool_t do_call, word_t badge,
     }
 }
 
+#ifdef CONFIG_MULTICAST
+exception_t
+multicastIPC(word_t badge, word_t limit, tcb_t *thread, endpoint_t *epptr)
+{
+    tcb_queue_t queue;
+    tcb_t *dest;
+    bool_t reschedule;
+    exception_t status;
+
+    setThreadState(thread, ThreadState_Restart);
+
+    /* Only threads that were waiting when the multicast started are sent
+     * to. Receivers are stamped in the order they queue, so those are the
+     * ones at the head of the queue stamped before the start, however many
+     * have since left or queued again. */
+    if (thread->tcbMulticastEP != epptr) {
+        thread->tcbMulticastEP = epptr;
+        thread->tcbMulticastStart = ksRecvStamp;
+        thread->tcbMulticastDelivered = 0;
+    }
+
+    /* Receivers are queued rather than switched to one at a time, and a
+     * single reschedule covers any of them outranking the sender */
+    reschedule = false;
+    status = EXCEPTION_NONE;
+    while ((limit == 0 || thread->tcbMulticastDelivered < limit) &&
+            endpoint_ptr_get_state(epptr) == EPState_Recv) {
+        queue = ep_ptr_get_queue(epptr);
+        dest = queue.head;
+
+        if ((sword_t)(dest->tcbRecvStamp - thread->tcbMulticastStart) >= 0) {
+            break;
+        }
+
+        queue = tcbEPDequeue(dest, queue);
+        ep_ptr_set_queue(epptr, queue);
+
+        if (!queue.head) {
+            endpoint_ptr_set_state(epptr, EPState_Idle);
+        }
+
+        doIPCTransfer(thread, epptr, badge, false, dest);
+
+        setThreadState(dest, ThreadState_Running);
+        SCHED_ENQUEUE(dest);
+        if (dest->tcbDomain == ksCurDomain &&
+                dest->tcbPriority > thread->tcbPriority
+                SMP_COND_STATEMENT( && dest->tcbAffinity == getCurrentCPUIndex())) {
+            reschedule = true;
+        }
+        thread->tcbMulticastDelivered++;
+
+        status = preemptionPoint();
+        if (unlikely(status != EXCEPTION_NONE)) {
+            break;
+        }
+    }
+
+    if (reschedule) {
+        rescheduleRequired();
+    }
+
+    if (status == EXCEPTION_NONE) {
+        setRegister(thread, badgeRegister, thread->tcbMulticastDelivered);
+        setThreadState(thread, ThreadState_Running);
+        thread->tcbMulticastEP = NULL;
+    }
+
+    return status;
+}
+#endif /* CONFIG_MULTICAST */
+
 void
 receiveIPC(tcb_t *thread, cap_t cap, bool_t isBlocking)
 {
@@ -129,6 +209,12 @@ receiveIPC(tcb_t *thread, cap_t cap, bool_t isBlocking)
             tcb_queue_t queue;
 
             if (isBlocking) {
+#ifdef CONFIG_PRIORITY_INHERITANCE
+                /* A server waiting for its next client is no longer
+                 * working on behalf of the one it inherited from */
+                restorePriority(thread);
+#endif
+
                 /* Set thread state to BlockedOnReceive */
                 thread_state_ptr_set_tsType(&thread->tcbState,
                                             ThreadState_BlockedOnReceive);
@@ -138,6 +224,9 @@ receiveIPC(tcb_t *thread, cap_t cap, bool_t isBlocking)
                 scheduleTCB(thread);
 
                 /* Place calling thread in endpoint queue */
+#ifdef CONFIG_MULTICAST
+                thread->tcbRecvStamp = ksRecvStamp++;
+#endif
                 queue = ep_ptr_get_queue(epptr);
                 queue = tcbEPAppend(thread, queue);
                 endpoint_ptr_set_state(epptr, EPState_Recv);
@@ -184,6 +273,9 @@ receiveIPC(tcb_t *thread, cap_t cap, bool_t isBlocking)
             if (do_call ||
                     seL4_Fault_get_seL4_FaultType(sender->tcbFault) != seL4_Fault_NullFault) {
                 if (canGrant) {
+#ifdef CONFIG_PRIORITY_INHERITANCE
+                    inheritPriority(thread, sender);
+#endif
                     setupCallerCap(sender, thread);
                 } else {
                     setThreadState(sender, ThreadState_Inactive);
@@ -21,6 +21,7 @@
 #include <kernel/cspace.h>
 #include <kernel/thread.h>
 #include <model/statedata.h>
+#include <model/kernel_stats.h>
 #include <machine/timer.h>
 #include <smp/ipi.h>
 
@@ -197,6 +198,7 @@ handleInterrupt(irq_t irq)
         ackInterrupt(irq);
         return;
     }
+    KERNEL_STATS_IRQ(irq);
     switch (intStateIRQTable[irq]) {
     case IRQSignal: {
         cap_t cap;
@@ -166,6 +166,9 @@ finaliseCap(cap_t cap, bool_t final, bool_t exposed)
             suspend(tcb);
 #ifdef CONFIG_DEBUG_BUILD
             tcbDebugRemove(tcb);
+#endif
+#ifdef CONFIG_THREAD_REGISTRY
+            tcbRegistryRemove(tcb);
 #endif
             Arch_prepareThreadDelete(tcb);
             fc_ret.remainder =
@@ -451,6 +454,9 @@ createObject(object_t t, void *regionBase, word_t userSize, bool_t deviceMemory)
         strlcat(tcb->tcbName, "'", TCB_NAME_LENGTH);
         tcbDebugAppend(tcb);
 #endif /* CONFIG_DEBUG_BUILD */
+#ifdef CONFIG_THREAD_REGISTRY
+        tcbRegistryAppend(tcb);
+#endif
 
         return cap_thread_cap_new(TCB_REF(tcb));
     }
@@ -22,11 +22,16 @@
 #include <kernel/cspace.h>
 #include <kernel/thread.h>
 #include <kernel/vspace.h>
+#include <model/preemption.h>
 #include <model/statedata.h>
 #include <util.h>
 #include <string.h>
 #include <stdint.h>
 #include <arch/smp/ipi_inline.h>
+#include <machine/fpu.h>
+#include <api/register_snapshot_types.h>
+#include <benchmark/benchmark_utilisation_types.h>
+#include <model/thread_registry_types.h>
 
 #define NULL_PRIO 0
 
@@ -204,6 +209,169 @@ void tcbDebugRemove(tcb_t *tcb)
 }
 #endif /* CONFIG_DEBUG_BUILD */
 
+#ifdef CONFIG_THREAD_REGISTRY
+/* Where the last threadRegistry_dump stopped, so that reading the registry
+ * in order does not walk it from the start on every call. The cursor is
+ * kept up to date as threads are added, and as the thread it refers to is
+ * removed. Removing any other thread invalidates it, as its index is then
+ * unknown. */
+static struct {
+    bool_t valid;
+    tcb_t *tcb;
+    word_t index;
+} registryCursor;
+
+void tcbRegistryAppend(tcb_t *tcb)
+{
+    /* prepend to the list */
+    tcb->tcbRegistryPrev = NULL;
+    if (registryCursor.valid) {
+        registryCursor.index++;
+    }
+
+    if (ksThreadRegistry) {
+        ksThreadRegistry->tcbRegistryPrev = tcb;
+    }
+
+    tcb->tcbRegistryNext = ksThreadRegistry;
+    ksThreadRegistry = tcb;
+}
+
+void tcbRegistryRemove(tcb_t *tcb)
+{
+    assert(ksThreadRegistry != NULL);
+    if (tcb == registryCursor.tcb) {
+        registryCursor.tcb = tcb->tcbRegistryNext;
+    } else {
+        registryCursor.valid = false;
+    }
+    if (tcb == ksThreadRegistry) {
+        ksThreadRegistry = ksThreadRegistry->tcbRegistryNext;
+    } else {
+        assert(tcb->tcbRegistryPrev);
+        tcb->tcbRegistryPrev->tcbRegistryNext = tcb->tcbRegistryNext;
+    }
+
+    if (tcb->tcbRegistryNext) {
+        tcb->tcbRegistryNext->tcbRegistryPrev = tcb->tcbRegistryPrev;
+    }
+
+    tcb->tcbRegistryPrev = NULL;
+    tcb->tcbRegistryNext = NULL;
+}
+
+exception_t
+threadRegistry_dump(word_t first)
+{
+    seL4_IPCBuffer *buffer;
+    seL4_ThreadRegistryEntry_t entry;
+    exception_t status;
+    tcb_t *tcb;
+    word_t i;
+
+    buffer = (seL4_IPCBuffer *)lookupIPCBuffer(true, NODE_STATE(ksCurThread));
+    if (!buffer) {
+        userError("ThreadRegistryDump: Failed to lookup IPC buffer.");
+        current_syscall_error.type = seL4_IllegalOperation;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (!registryCursor.valid || registryCursor.index > first) {
+        registryCursor.valid = true;
+        registryCursor.tcb = ksThreadRegistry;
+        registryCursor.index = 0;
+    }
+
+    while (registryCursor.tcb != NULL && registryCursor.index < first) {
+        registryCursor.tcb = registryCursor.tcb->tcbRegistryNext;
+        registryCursor.index++;
+
+        status = preemptionPoint();
+        if (status != EXCEPTION_NONE) {
+            return status;
+        }
+    }
+    tcb = registryCursor.tcb;
+
+    /* Entries are copied bytewise as the message registers need not be
+     * aligned for the 64 bit fields */
+    for (i = 0; tcb != NULL &&
+            (i + 1) * sizeof(seL4_ThreadRegistryEntry_t) <= sizeof(buffer->msg);
+            tcb = tcb->tcbRegistryNext, i++) {
+        entry.tag = tcb->tcbTag;
+        entry.thread = (word_t)tcb;
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+        entry.utilisation = tcb->benchmark.utilisation;
+        entry.user_time = tcb->benchmark.user_time;
+        memcpy(entry.kernel_time, tcb->benchmark.kernel_time, sizeof(entry.kernel_time));
+#endif
+        memcpy((char *)buffer->msg + i * sizeof(seL4_ThreadRegistryEntry_t), &entry,
+               sizeof(seL4_ThreadRegistryEntry_t));
+    }
+
+    /* the next call in order continues from here */
+    registryCursor.tcb = tcb;
+    registryCursor.index += i;
+
+    /* Number of entries written */
+    setRegister(NODE_STATE(ksCurThread), msgInfoRegister, i);
+    return EXCEPTION_NONE;
+}
+#endif /* CONFIG_THREAD_REGISTRY */
+
+#ifdef CONFIG_KERNEL_TIMEOUTS
+/* Add TCB to the sleep queue of its node, behind any threads with the
+ * same deadline */
+void
+tcbSleepEnqueue(tcb_t *tcb, word_t deadline)
+{
+    tcb_t *prev = NULL;
+    tcb_t *next = NODE_STATE_ON_CORE(ksSleepQueue, tcb->tcbAffinity);
+
+    assert(!tcb->tcbSleeping);
+
+    while (next && (sword_t)(next->tcbDeadline - deadline) <= 0) {
+        prev = next;
+        next = next->tcbSleepNext;
+    }
+
+    tcb->tcbDeadline = deadline;
+    tcb->tcbSleepPrev = prev;
+    tcb->tcbSleepNext = next;
+
+    if (prev) {
+        prev->tcbSleepNext = tcb;
+    } else {
+        NODE_STATE_ON_CORE(ksSleepQueue, tcb->tcbAffinity) = tcb;
+    }
+    if (next) {
+        next->tcbSleepPrev = tcb;
+    }
+
+    tcb->tcbSleeping = true;
+}
+
+/* Remove TCB from the sleep queue of its node */
+void
+tcbSleepDequeue(tcb_t *tcb)
+{
+    assert(tcb->tcbSleeping);
+
+    if (tcb->tcbSleepPrev) {
+        tcb->tcbSleepPrev->tcbSleepNext = tcb->tcbSleepNext;
+    } else {
+        NODE_STATE_ON_CORE(ksSleepQueue, tcb->tcbAffinity) = tcb->tcbSleepNext;
+    }
+    if (tcb->tcbSleepNext) {
+        tcb->tcbSleepNext->tcbSleepPrev = tcb->tcbSleepPrev;
+    }
+
+    tcb->tcbSleepPrev = NULL;
+    tcb->tcbSleepNext = NULL;
+    tcb->tcbSleeping = false;
+}
+#endif /* CONFIG_KERNEL_TIMEOUTS */
+
 /* Add TCB to the end of an endpoint queue */
 tcb_queue_t
 tcbEPAppend(tcb_t *tcb, tcb_queue_t queue)
@@ -377,15 +545,30 @@ remoteTCBStall(tcb_t *tcb)
 static exception_t
 invokeTCB_SetAffinity(tcb_t *thread, word_t affinity)
 {
+#ifdef CONFIG_KERNEL_TIMEOUTS
+    bool_t sleeping = thread->tcbSleeping;
+#endif
+
     Arch_migrateTCB(thread);
 
     /* remove the tcb from scheduler queue in case it is already in one
      * and add it to new queue if required */
     tcbSchedDequeue(thread);
+#ifdef CONFIG_KERNEL_TIMEOUTS
+    /* a timed wait follows the thread to the sleep queue of its new node */
+    if (sleeping) {
+        tcbSleepDequeue(thread);
+    }
+#endif
     thread->tcbAffinity = affinity;
     if (isRunnable(thread)) {
         SCHED_APPEND(thread);
     }
+#ifdef CONFIG_KERNEL_TIMEOUTS
+    if (sleeping) {
+        tcbSleepEnqueue(thread, thread->tcbDeadline);
+    }
+#endif
 
     /* reschedule current cpu if tcb moves itself */
     if (thread == NODE_STATE(ksCurThread)) {
@@ -708,6 +891,26 @@ decodeTCBInvocation(word_t invLabel, word_t length, cap_t cap,
     case TCBUnbindNotification:
         return decodeUnbindNotification(cap);
 
+#ifdef CONFIG_FRAME_DONATION
+    case TCBSetDonationWindow:
+        return decodeSetDonationWindow(cap, length, buffer);
+#endif
+
+#ifdef CONFIG_FAULT_PROFILES
+    case TCBSetFaultProfile:
+        return decodeSetFaultProfile(cap, length, buffer);
+#endif
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    case TCBSetPriorityInheritance:
+        return decodeSetPriorityInheritance(cap, length, buffer);
+#endif
+
+#ifdef CONFIG_THREAD_REGISTRY
+    case TCBSetTag:
+        return decodeSetTag(cap, length, buffer);
+#endif
+
 #ifdef ENABLE_SMP_SUPPORT
     case TCBSetAffinity:
         return decodeSetAffinity(cap, length, buffer);
@@ -1292,6 +1495,121 @@ decodeUnbindNotification(cap_t cap)
     return invokeTCB_NotificationControl(tcb, NULL);
 }
 
+#ifdef CONFIG_FRAME_DONATION
+exception_t
+decodeSetDonationWindow(cap_t cap, word_t length, word_t *buffer)
+{
+    word_t window, windowPages, maxPages;
+    bool_t donate;
+
+    if (length < 3) {
+        userError("TCB SetDonationWindow: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    window      = getSyscallArg(0, buffer);
+    windowPages = getSyscallArg(1, buffer);
+    donate      = getSyscallArg(2, buffer) != 0;
+
+    if (!IS_ALIGNED(window, seL4_PageBits)) {
+        userError("TCB SetDonationWindow: Window 0x%lx is not page aligned.", (long)window);
+        current_syscall_error.type = seL4_AlignmentError;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* Keep the window within a single page table, so that finding a free
+     * page in it is a single bounded scan */
+    maxPages = BIT(seL4_PageTableIndexBits) -
+               ((window >> seL4_PageBits) & MASK(seL4_PageTableIndexBits));
+    if (windowPages > maxPages) {
+        userError("TCB SetDonationWindow: Window crosses a page table boundary.");
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = maxPages;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return invokeTCB_SetDonationWindow(TCB_PTR(cap_thread_cap_get_capTCBPtr(cap)),
+                                       window, windowPages, donate);
+}
+#endif /* CONFIG_FRAME_DONATION */
+
+#ifdef CONFIG_FAULT_PROFILES
+exception_t
+decodeSetFaultProfile(cap_t cap, word_t length, word_t *buffer)
+{
+    word_t syscallRegs, exceptionRegs;
+
+    if (length < 2) {
+        userError("TCB SetFaultProfile: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    syscallRegs   = getSyscallArg(0, buffer);
+    exceptionRegs = getSyscallArg(1, buffer);
+
+    if (syscallRegs & ~MASK(n_syscallMessage)) {
+        userError("TCB SetFaultProfile: Invalid unknown syscall registers 0x%lx.", (long)syscallRegs);
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (exceptionRegs & ~MASK(n_exceptionMessage)) {
+        userError("TCB SetFaultProfile: Invalid user exception registers 0x%lx.", (long)exceptionRegs);
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return invokeTCB_SetFaultProfile(TCB_PTR(cap_thread_cap_get_capTCBPtr(cap)),
+                                     syscallRegs, exceptionRegs);
+}
+#endif /* CONFIG_FAULT_PROFILES */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+exception_t
+decodeSetPriorityInheritance(cap_t cap, word_t length, word_t *buffer)
+{
+    if (length < 1) {
+        userError("TCB SetPriorityInheritance: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return invokeTCB_SetPriorityInheritance(TCB_PTR(cap_thread_cap_get_capTCBPtr(cap)),
+                                            !!getSyscallArg(0, buffer));
+}
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+
+#ifdef CONFIG_THREAD_REGISTRY
+exception_t
+decodeSetTag(cap_t cap, word_t length, word_t *buffer)
+{
+    uint64_t tag;
+
+    if (length < 64 / wordBits) {
+        userError("TCB SetTag: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+#if CONFIG_WORD_SIZE == 32
+    tag = getSyscallArg(0, buffer) | ((uint64_t)getSyscallArg(1, buffer) << 32);
+#else
+    tag = getSyscallArg(0, buffer);
+#endif
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return invokeTCB_SetTag(TCB_PTR(cap_thread_cap_get_capTCBPtr(cap)), tag);
+}
+#endif /* CONFIG_THREAD_REGISTRY */
+
 /* The following functions sit in the preemption monad and implement the
  * preemptible, non-faulting bottom end of a TCB invocation. */
 exception_t
@@ -1329,6 +1647,9 @@ invokeTCB_ThreadControl(tcb_t *target, cte_t* slot,
     }
 
     if (updateFlags & thread_control_update_priority) {
+#ifdef CONFIG_PRIORITY_INHERITANCE
+        target->tcbBoosted = false;
+#endif
         setPriority(target, priority);
     }
 
@@ -1411,6 +1732,11 @@ invokeTCB_CopyRegisters(tcb_t *dest, tcb_t *tcb_src,
 
         pc = getRestartPC(dest);
         setNextPC(dest, pc);
+
+#ifdef CONFIG_MULTICAST
+        /* whatever the thread restarts is no longer its preempted multicast */
+        dest->tcbMulticastEP = NULL;
+#endif
     }
 
     if (transferInteger) {
@@ -1551,6 +1877,9 @@ invokeTCB_WriteRegisters(tcb_t *dest, bool_t resumeTarget,
 
     pc = getRestartPC(dest);
     setNextPC(dest, pc);
+#ifdef CONFIG_MULTICAST
+    dest->tcbMulticastEP = NULL;
+#endif
 
     if (resumeTarget) {
         restart(dest);
@@ -1565,6 +1894,276 @@ invokeTCB_WriteRegisters(tcb_t *dest, bool_t resumeTarget,
     return EXCEPTION_NONE;
 }
 
+/* State of a SaveRegisters or RestoreRegisters call in progress, so that a
+ * preempted call continues from the thread it stopped at. The window and the
+ * frame are looked up from the invoked caps on every call, and the call only
+ * continues if they are unchanged. */
+static struct {
+    tcb_t *thread;
+    word_t label;
+    cte_t *window;
+    word_t count;
+    word_t *frame;
+    word_t next;
+    word_t numRecords;
+} registerSnapshot;
+
+static inline word_t
+registerSnapshotFpuSize(void)
+{
+#ifdef CONFIG_HAVE_FPU
+    return sizeof(user_fpu_state_t);
+#else
+    return 0;
+#endif
+}
+
+static inline word_t
+registerSnapshotRecordSize(void)
+{
+    return (1 + n_frameRegisters + n_gpRegisters) * sizeof(word_t) +
+           ROUND_UP(registerSnapshotFpuSize(), wordRadix - 3);
+}
+
+static inline word_t *
+registerSnapshotRecord(word_t index)
+{
+    return (word_t *)((word_t)registerSnapshot.frame + sizeof(seL4_RegisterSnapshotHeader_t) +
+                      index * registerSnapshotRecordSize());
+}
+
+/* Returns the thread in a slot of the window that registers can be saved
+ * from or restored to, or NULL */
+static tcb_t *
+registerSnapshotThread(word_t slot)
+{
+    cap_t cap;
+    tcb_t *tcb;
+
+    cap = registerSnapshot.window[slot].cap;
+    if (cap_get_capType(cap) != cap_thread_cap) {
+        return NULL;
+    }
+    tcb = TCB_PTR(cap_thread_cap_get_capTCBPtr(cap));
+    if (tcb == NODE_STATE(ksCurThread)) {
+        return NULL;
+    }
+    return tcb;
+}
+
+static exception_t
+invokeCNode_SaveRegisters(bool_t suspendThreads, word_t capacity)
+{
+    seL4_RegisterSnapshotHeader_t *header;
+    word_t *record;
+    word_t i;
+    tcb_t *tcb;
+    exception_t status;
+
+    while (registerSnapshot.next < registerSnapshot.count) {
+        tcb = registerSnapshotThread(registerSnapshot.next);
+        if (tcb != NULL) {
+            if (registerSnapshot.numRecords == capacity) {
+                break;
+            }
+            SMP_COND_STATEMENT(remoteTCBStall(tcb);)
+            if (suspendThreads) {
+                suspend(tcb);
+            }
+
+            record = registerSnapshotRecord(registerSnapshot.numRecords);
+            record[0] = registerSnapshot.next;
+            for (i = 0; i < n_frameRegisters; i++) {
+                record[1 + i] = getRegister(tcb, frameRegisters[i]);
+            }
+            for (i = 0; i < n_gpRegisters; i++) {
+                record[1 + n_frameRegisters + i] = getRegister(tcb, gpRegisters[i]);
+            }
+#ifdef CONFIG_HAVE_FPU
+            if (nativeThreadUsingFPU(tcb)) {
+                switchFpuOwner(NULL, SMP_TERNARY(tcb->tcbAffinity, 0));
+            }
+            memcpy(&record[1 + n_frameRegisters + n_gpRegisters],
+                   &tcb->tcbArch.tcbContext.fpuState, sizeof(user_fpu_state_t));
+#endif
+            registerSnapshot.numRecords++;
+        }
+        registerSnapshot.next++;
+
+        if (tcb != NULL) {
+            status = preemptionPoint();
+            if (unlikely(status != EXCEPTION_NONE)) {
+                return status;
+            }
+        }
+    }
+
+    header = (seL4_RegisterSnapshotHeader_t *)registerSnapshot.frame;
+    header->magic = seL4_RegisterSnapshotMagic;
+    header->version = seL4_RegisterSnapshotVersion;
+    header->numRecords = registerSnapshot.numRecords;
+    header->recordSize = registerSnapshotRecordSize();
+    header->numRegisters = n_frameRegisters + n_gpRegisters;
+    header->fpuSize = registerSnapshotFpuSize();
+    header->nextSlot = registerSnapshot.next;
+
+    return EXCEPTION_NONE;
+}
+
+static exception_t
+invokeCNode_RestoreRegisters(bool_t resumeThreads)
+{
+    word_t *record;
+    word_t i;
+    bool_t archInfo;
+    tcb_t *tcb;
+    exception_t status;
+
+    while (registerSnapshot.next < registerSnapshot.numRecords) {
+        record = registerSnapshotRecord(registerSnapshot.next);
+        tcb = NULL;
+        if (record[0] < registerSnapshot.count) {
+            tcb = registerSnapshotThread(record[0]);
+        }
+        if (unlikely(tcb == NULL)) {
+            userError("CNode RestoreRegisters: Record %lu does not name a thread in the window.",
+                      (unsigned long)registerSnapshot.next);
+            current_syscall_error.type = seL4_InvalidArgument;
+            current_syscall_error.invalidArgumentNumber = 3;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        SMP_COND_STATEMENT(remoteTCBStall(tcb);)
+
+        archInfo = Arch_getSanitiseRegisterInfo(tcb);
+        for (i = 0; i < n_frameRegisters; i++) {
+            setRegister(tcb, frameRegisters[i],
+                        sanitiseRegister(frameRegisters[i], record[1 + i], archInfo));
+        }
+        for (i = 0; i < n_gpRegisters; i++) {
+            setRegister(tcb, gpRegisters[i],
+                        sanitiseRegister(gpRegisters[i], record[1 + n_frameRegisters + i], archInfo));
+        }
+#ifdef CONFIG_ARCH_X86_64
+        /* Force the return to user to go via the IRQ path, which reloads all
+         * registers, as in invokeTCB_WriteRegisters */
+        setRegister(tcb, Error, 0);
+#endif
+        setNextPC(tcb, getRestartPC(tcb));
+
+#ifdef CONFIG_HAVE_FPU
+        /* the live state would otherwise overwrite the restored state
+         * when it is next switched out */
+        if (nativeThreadUsingFPU(tcb)) {
+            switchFpuOwner(NULL, SMP_TERNARY(tcb->tcbAffinity, 0));
+        }
+        Arch_setFpuState(&tcb->tcbArch.tcbContext.fpuState,
+                         &record[1 + n_frameRegisters + n_gpRegisters]);
+#endif
+
+        if (resumeThreads) {
+            restart(tcb);
+        }
+        registerSnapshot.next++;
+
+        status = preemptionPoint();
+        if (unlikely(status != EXCEPTION_NONE)) {
+            return status;
+        }
+    }
+
+    return EXCEPTION_NONE;
+}
+
+exception_t
+decodeCNodeRegisters(word_t invLabel, word_t length, cap_t cap,
+                     extra_caps_t excaps, word_t *buffer)
+{
+    seL4_RegisterSnapshotHeader_t *header;
+    cte_t *window;
+    word_t first, count, flag, frameSize, capacity;
+    word_t *frame;
+    cap_t frameCap;
+    bool_t save;
+    exception_t status;
+
+    save = invLabel == CNodeSaveRegisters;
+    header = NULL;
+
+    if (length < 3 || excaps.excaprefs[0] == NULL) {
+        userError("CNode Save/RestoreRegisters: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    first = getSyscallArg(0, buffer);
+    count = getSyscallArg(1, buffer);
+    flag  = getSyscallArg(2, buffer);
+    frameCap = excaps.excaprefs[0]->cap;
+
+    if (first >= BIT(cap_cnode_cap_get_capCNodeRadix(cap)) ||
+            count > BIT(cap_cnode_cap_get_capCNodeRadix(cap)) - first) {
+        userError("CNode Save/RestoreRegisters: Window is not within the CNode.");
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = BIT(cap_cnode_cap_get_capCNodeRadix(cap));
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (!Arch_isUserAccessibleFrame(frameCap, save)) {
+        userError("CNode Save/RestoreRegisters: Invalid frame.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    window = CTE_PTR(cap_cnode_cap_get_capCNodePtr(cap)) + first;
+    frame = (word_t *)cap_get_capPtr(frameCap);
+    frameSize = BIT(cap_get_capSizeBits(frameCap));
+    capacity = (frameSize - sizeof(seL4_RegisterSnapshotHeader_t)) / registerSnapshotRecordSize();
+
+    if (!save) {
+        header = (seL4_RegisterSnapshotHeader_t *)frame;
+        if (header->magic != seL4_RegisterSnapshotMagic ||
+                header->version != seL4_RegisterSnapshotVersion ||
+                header->recordSize != registerSnapshotRecordSize() ||
+                header->numRegisters != n_frameRegisters + n_gpRegisters ||
+                header->fpuSize != registerSnapshotFpuSize() ||
+                header->numRecords > capacity) {
+            userError("CNode RestoreRegisters: Frame does not hold a snapshot of this kernel.");
+            current_syscall_error.type = seL4_InvalidArgument;
+            current_syscall_error.invalidArgumentNumber = 3;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+
+    if (registerSnapshot.thread != NODE_STATE(ksCurThread) ||
+            registerSnapshot.label != invLabel ||
+            registerSnapshot.window != window ||
+            registerSnapshot.count != count ||
+            registerSnapshot.frame != frame) {
+        registerSnapshot.thread = NODE_STATE(ksCurThread);
+        registerSnapshot.label = invLabel;
+        registerSnapshot.window = window;
+        registerSnapshot.count = count;
+        registerSnapshot.frame = frame;
+        registerSnapshot.next = 0;
+        registerSnapshot.numRecords = save ? 0 : header->numRecords;
+    }
+
+    if (save) {
+        status = invokeCNode_SaveRegisters(flag, capacity);
+    } else {
+        status = invokeCNode_RestoreRegisters(flag);
+    }
+
+    if (status != EXCEPTION_PREEMPTED) {
+        registerSnapshot.thread = NULL;
+    }
+    return status;
+}
+
 exception_t
 invokeTCB_NotificationControl(tcb_t *tcb, notification_t *ntfnPtr)
 {
@@ -1577,6 +2176,53 @@ invokeTCB_NotificationControl(tcb_t *tcb, notification_t *ntfnPtr)
     return EXCEPTION_NONE;
 }
 
+#ifdef CONFIG_FRAME_DONATION
+exception_t
+invokeTCB_SetDonationWindow(tcb_t *tcb, word_t window, word_t windowPages,
+                            bool_t donate)
+{
+    tcb->tcbDonationWindow = window;
+    tcb->tcbDonationWindowPages = windowPages;
+    tcb->tcbDonateFrames = donate;
+
+    return EXCEPTION_NONE;
+}
+#endif /* CONFIG_FRAME_DONATION */
+
+#ifdef CONFIG_FAULT_PROFILES
+exception_t
+invokeTCB_SetFaultProfile(tcb_t *tcb, word_t syscallRegs, word_t exceptionRegs)
+{
+    tcb->tcbSyscallFaultRegs = syscallRegs;
+    tcb->tcbExceptionFaultRegs = exceptionRegs;
+
+    return EXCEPTION_NONE;
+}
+#endif /* CONFIG_FAULT_PROFILES */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+exception_t
+invokeTCB_SetPriorityInheritance(tcb_t *tcb, bool_t inherit)
+{
+    tcb->tcbInheritPriority = inherit;
+    if (!inherit) {
+        restorePriority(tcb);
+    }
+
+    return EXCEPTION_NONE;
+}
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+
+#ifdef CONFIG_THREAD_REGISTRY
+exception_t
+invokeTCB_SetTag(tcb_t *tcb, uint64_t tag)
+{
+    tcb->tcbTag = tag;
+
+    return EXCEPTION_NONE;
+}
+#endif /* CONFIG_THREAD_REGISTRY */
+
 #ifdef CONFIG_DEBUG_BUILD
 void
 setThreadName(tcb_t *tcb, const char *name)
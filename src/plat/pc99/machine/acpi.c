@@ -170,11 +170,81 @@ typedef struct acpi_madt_iso {
 unverified_compile_assert(acpi_madt_iso_packed,
                           OFFSETOF(acpi_madt_iso_t, flags) == sizeof(acpi_madt_header_t) + 6)
 
+/* System Resource Affinity Table (SRAT) */
+typedef struct acpi_srat {
+    acpi_header_t header;
+    uint32_t      reserved1;
+    uint8_t       reserved2[8];
+} acpi_srat_t;
+compile_assert(acpi_srat_packed,
+               sizeof(acpi_srat_t) == sizeof(acpi_header_t) + 12)
+
+typedef struct acpi_srat_header {
+    uint8_t type;
+    uint8_t length;
+} acpi_srat_header_t;
+compile_assert(acpi_srat_header_packed, sizeof(acpi_srat_header_t) == 2)
+
+enum acpi_table_srat_struct_type {
+    SRAT_APIC   = 0,
+    SRAT_MEM    = 1,
+    SRAT_x2APIC = 2
+};
+
+#define SRAT_ENABLED BIT(0)
+
+typedef struct acpi_srat_apic {
+    acpi_srat_header_t header;
+    uint8_t            proximity_lo;
+    uint8_t            apic_id;
+    uint32_t           flags;
+    uint8_t            sapic_eid;
+    uint8_t            proximity_hi[3];
+    uint32_t           clock_domain;
+} PACKED acpi_srat_apic_t;
+compile_assert(acpi_srat_apic_packed,
+               sizeof(acpi_srat_apic_t) == sizeof(acpi_srat_header_t) + 14)
+
+typedef struct acpi_srat_mem {
+    acpi_srat_header_t header;
+    uint32_t           proximity;
+    uint16_t           reserved1;
+    uint32_t           base[2];
+    uint32_t           length[2];
+    uint32_t           reserved2;
+    uint32_t           flags;
+    uint32_t           reserved3[2];
+} PACKED acpi_srat_mem_t;
+compile_assert(acpi_srat_mem_packed,
+               sizeof(acpi_srat_mem_t) == sizeof(acpi_srat_header_t) + 38)
+
+typedef struct acpi_srat_x2apic {
+    acpi_srat_header_t header;
+    uint16_t           reserved1;
+    uint32_t           proximity;
+    uint32_t           x2apic_id;
+    uint32_t           flags;
+    uint32_t           clock_domain;
+    uint32_t           reserved2;
+} PACKED acpi_srat_x2apic_t;
+compile_assert(acpi_srat_x2apic_packed,
+               sizeof(acpi_srat_x2apic_t) == sizeof(acpi_srat_header_t) + 22)
+
+/* System Locality Information Table (SLIT) */
+typedef struct acpi_slit {
+    acpi_header_t header;
+    uint32_t      num_localities[2];
+} acpi_slit_t;
+compile_assert(acpi_slit_packed,
+               sizeof(acpi_slit_t) == sizeof(acpi_header_t) + 8)
+
 /* workaround because string literals are not supported by C parser */
 const char acpi_str_rsd[]  = {'R', 'S', 'D', ' ', 'P', 'T', 'R', ' ', 0};
 const char acpi_str_fadt[] = {'F', 'A', 'C', 'P', 0};
 const char acpi_str_apic[] = {'A', 'P', 'I', 'C', 0};
 const char acpi_str_dmar[] = {'D', 'M', 'A', 'R', 0};
+const char acpi_str_srat[] = {'S', 'R', 'A', 'T', 0};
+const char acpi_str_slit[] = {'S', 'L', 'I', 'T', 0};
 
 BOOT_CODE static uint8_t
 acpi_calc_checksum(char* start, uint32_t length)
@@ -547,3 +617,188 @@ acpi_dmar_scan(
     rmrr_list->num = rmrr_count;
     printf("ACPI: %d IOMMUs detected\n", *num_drhu);
 }
+
+BOOT_CODE static bool_t
+acpi_srat_add_cpu(acpi_numa_info_t* numa_info, cpu_id_t apic_id, uint32_t node)
+{
+    if (node >= SEL4_X86_MAX_NUMA_NODES) {
+        printf("ACPI: SRAT proximity domain %d too large, only support %d\n",
+               node, SEL4_X86_MAX_NUMA_NODES);
+        return false;
+    }
+    if (numa_info->num_cpus == MAX_NUM_NUMA_CPUS) {
+        printf("ACPI: Not recording SRAT APIC 0x%lx, only support %d\n", apic_id, MAX_NUM_NUMA_CPUS);
+        return true;
+    }
+    numa_info->cpus[numa_info->num_cpus].apic_id = apic_id;
+    numa_info->cpus[numa_info->num_cpus].node = node;
+    numa_info->num_cpus++;
+    numa_info->num_nodes = MAX(numa_info->num_nodes, node + 1);
+    return true;
+}
+
+BOOT_CODE static bool_t
+acpi_srat_add_mem(acpi_numa_info_t* numa_info, acpi_srat_mem_t* mem)
+{
+    uint64_t base = ((uint64_t)mem->base[1] << 32) | mem->base[0];
+    uint64_t length = ((uint64_t)mem->length[1] << 32) | mem->length[0];
+    uint64_t end = base + length;
+
+    if (mem->proximity >= SEL4_X86_MAX_NUMA_NODES) {
+        printf("ACPI: SRAT proximity domain %d too large, only support %d\n",
+               mem->proximity, SEL4_X86_MAX_NUMA_NODES);
+        return false;
+    }
+
+    /* we can only describe memory that is addressable as a paddr_t */
+    if (end > (paddr_t)-1) {
+        end = (paddr_t)-1;
+    }
+    if (base >= end) {
+        return true;
+    }
+
+    printf("ACPI: SRAT_MEM node=%d paddr=0x%llx..0x%llx\n",
+           mem->proximity, (unsigned long long)base, (unsigned long long)end);
+    if (numa_info->num_mem == MAX_NUM_NUMA_MEM_REGIONS) {
+        printf("ACPI: Not recording this memory range, only support %d\n", MAX_NUM_NUMA_MEM_REGIONS);
+        return true;
+    }
+    numa_info->mem[numa_info->num_mem] = (acpi_numa_mem_t) {
+        .p_reg = { .start = base, .end = end }, .node = mem->proximity
+    };
+    numa_info->num_mem++;
+    numa_info->num_nodes = MAX(numa_info->num_nodes, mem->proximity + 1);
+    return true;
+}
+
+BOOT_CODE static void
+acpi_slit_scan(acpi_slit_t* acpi_slit_mapped, acpi_numa_info_t* numa_info)
+{
+    uint8_t* entries = (uint8_t*)(acpi_slit_mapped + 1);
+    uint32_t num;
+    uint32_t i, j;
+
+    if (acpi_slit_mapped->num_localities[1] != 0 ||
+            acpi_slit_mapped->num_localities[0] > SEL4_X86_MAX_NUMA_NODES) {
+        printf("ACPI: SLIT has too many localities, ignoring\n");
+        return;
+    }
+    num = acpi_slit_mapped->num_localities[0];
+    if (acpi_slit_mapped->header.length < sizeof(acpi_slit_t) + num * num) {
+        printf("ACPI: SLIT truncated, ignoring\n");
+        return;
+    }
+
+    for (i = 0; i < num; i++) {
+        for (j = 0; j < num; j++) {
+            numa_info->distance[i][j] = entries[i * num + j];
+        }
+    }
+}
+
+BOOT_CODE void
+acpi_srat_scan(
+    acpi_rsdt_t* acpi_rsdt,
+    acpi_numa_info_t* numa_info
+)
+{
+    unsigned int entries;
+    uint32_t count;
+    acpi_srat_t* acpi_srat;
+    acpi_srat_header_t* acpi_srat_header;
+    bool_t valid = true;
+
+    acpi_rsdt_t* acpi_rsdt_mapped;
+    acpi_srat_t* acpi_srat_mapped;
+
+    memzero(numa_info, sizeof(*numa_info));
+
+    acpi_rsdt_mapped = (acpi_rsdt_t*)acpi_table_init(acpi_rsdt, ACPI_RSDT);
+
+    assert(acpi_rsdt_mapped->header.length >= sizeof(acpi_header_t));
+    /* Divide by uint32_t explicitly as this is the size as mandated by the ACPI standard */
+    entries = (acpi_rsdt_mapped->header.length - sizeof(acpi_header_t)) / sizeof(uint32_t);
+    for (count = 0; count < entries && valid; count++) {
+        acpi_srat = (acpi_srat_t*)(word_t)acpi_rsdt_mapped->entry[count];
+        acpi_srat_mapped = (acpi_srat_t*)acpi_table_init(acpi_srat, ACPI_RSDT);
+
+        if (strncmp(acpi_str_slit, acpi_srat_mapped->header.signature, 4) == 0) {
+            printf("ACPI: SLIT paddr=%p\n", acpi_srat);
+            acpi_slit_scan((acpi_slit_t*)acpi_srat_mapped, numa_info);
+            continue;
+        }
+
+        if (strncmp(acpi_str_srat, acpi_srat_mapped->header.signature, 4) != 0) {
+            continue;
+        }
+
+        printf("ACPI: SRAT paddr=%p\n", acpi_srat);
+        printf("ACPI: SRAT vaddr=%p\n", acpi_srat_mapped);
+
+        acpi_srat_header = (acpi_srat_header_t*)(acpi_srat_mapped + 1);
+
+        while (valid && (char*)acpi_srat_header < (char*)acpi_srat_mapped + acpi_srat_mapped->header.length) {
+            if (acpi_srat_header->length == 0) {
+                printf("ACPI: SRAT entry of length 0, ignoring SRAT\n");
+                valid = false;
+                break;
+            }
+            switch (acpi_srat_header->type) {
+            case SRAT_APIC: {
+                acpi_srat_apic_t* apic = (acpi_srat_apic_t*)acpi_srat_header;
+                if (apic->flags & SRAT_ENABLED) {
+                    uint32_t node = apic->proximity_lo |
+                                    (apic->proximity_hi[0] << 8) |
+                                    (apic->proximity_hi[1] << 16) |
+                                    (apic->proximity_hi[2] << 24);
+                    printf("ACPI: SRAT_APIC apic_id=0x%x node=%d\n", apic->apic_id, node);
+                    valid = acpi_srat_add_cpu(numa_info, apic->apic_id, node);
+                }
+                break;
+            }
+            case SRAT_x2APIC: {
+                acpi_srat_x2apic_t* x2apic = (acpi_srat_x2apic_t*)acpi_srat_header;
+                if (x2apic->flags & SRAT_ENABLED) {
+                    printf("ACPI: SRAT_x2APIC apic_id=0x%x node=%d\n", x2apic->x2apic_id, x2apic->proximity);
+                    valid = acpi_srat_add_cpu(numa_info, x2apic->x2apic_id, x2apic->proximity);
+                }
+                break;
+            }
+            case SRAT_MEM: {
+                acpi_srat_mem_t* mem = (acpi_srat_mem_t*)acpi_srat_header;
+                if (mem->flags & SRAT_ENABLED) {
+                    valid = acpi_srat_add_mem(numa_info, mem);
+                }
+                break;
+            }
+            default:
+                break;
+            }
+            acpi_srat_header = (acpi_srat_header_t*)((char*)acpi_srat_header + acpi_srat_header->length);
+        }
+    }
+
+    if (!valid) {
+        /* fall back to treating the machine as a single node */
+        memzero(numa_info, sizeof(*numa_info));
+    }
+
+    printf("ACPI: %d NUMA node(s) detected\n", numa_info->num_nodes);
+}
+
+BOOT_CODE uint32_t
+acpi_numa_cpu_node(
+    acpi_numa_info_t* numa_info,
+    cpu_id_t apic_id
+)
+{
+    uint32_t i;
+
+    for (i = 0; i < numa_info->num_cpus; i++) {
+        if (numa_info->cpus[i].apic_id == apic_id) {
+            return numa_info->cpus[i].node;
+        }
+    }
+    return 0;
+}
@@ -64,6 +64,8 @@
 #define FAULT       31
 #define NFR         8   /* high word of CAP_REG */
 #define NFR_MASK    0xff
+#define SLLPS       2   /* Second Level Large Page Support, high word of CAP_REG */
+#define SLLPS_MASK  0xf
 #define PPF         1
 #define PPF_MASK    1
 #define PRESENT     1
@@ -312,7 +314,7 @@ vtd_map_reserved_page(vtd_cte_t *vtd_context_table, int context_index, paddr_t a
         vtd_pte_slot = iopt + iopt_index;
         if (i == 0) {
             /* Now put the mapping in */
-            *vtd_pte_slot = vtd_pte_new(addr, 1, 1);
+            *vtd_pte_slot = vtd_pte_new(addr, 0, 1, 1);
             flushCacheRange(vtd_pte_slot, VTD_PTE_SIZE_BITS);
         } else {
             if (!vtd_pte_ptr_get_write(vtd_pte_slot)) {
@@ -323,7 +325,7 @@ vtd_map_reserved_page(vtd_cte_t *vtd_context_table, int context_index, paddr_t a
                 memzero(iopt, BIT(seL4_IOPageTableBits));
                 flushCacheRange(iopt, seL4_IOPageTableBits);
 
-                *vtd_pte_slot = vtd_pte_new(pptr_to_paddr(iopt), 1, 1);
+                *vtd_pte_slot = vtd_pte_new(pptr_to_paddr(iopt), 0, 1, 1);
                 flushCacheRange(vtd_pte_slot, VTD_PTE_SIZE_BITS);
             } else {
                 iopt = (vtd_pte_t*)paddr_to_pptr(vtd_pte_ptr_get_addr(vtd_pte_slot));
@@ -442,6 +444,7 @@ vtd_init(
     drhu_id_t i;
     uint32_t  bus;
     uint32_t  aw_bitmask = 0xffffffff;
+    uint32_t  sllps_bitmask = SLLPS_MASK;
     uint32_t  max_num_iopt_levels;
     /* Start the number of domains at 16 bits */
     uint32_t  num_domain_id_bits = 16;
@@ -456,6 +459,7 @@ vtd_init(
     for (i = 0; i < x86KSnumDrhu; i++) {
         uint32_t bits_supported = 4 + 2 * (vtd_read32(i, CAP_REG) & 7);
         aw_bitmask &= vtd_read32(i, CAP_REG) >> SAGAW;
+        sllps_bitmask &= vtd_read32(i, CAP_REG + 4) >> SLLPS;
         printf("IOMMU 0x%x: %d-bit domain IDs supported\n", i, bits_supported);
         if (bits_supported < num_domain_id_bits) {
             num_domain_id_bits = bits_supported;
@@ -496,6 +500,17 @@ vtd_init(
 
     printf("IOMMU: Using %d page-table levels (max. supported: %d)\n", x86KSnumIOPTLevels, max_num_iopt_levels);
 
+    /* Leaf entries above the bottom level are only used for page sizes that
+     * every IOMMU supports, 2M first, then 1G and so on. The root level,
+     * x86KSnumIOPTLevels - 1, always refers to a table, so the highest
+     * superpage level is the one below it. */
+    x86KSnumIOSuperPageLevels = 0;
+    while (x86KSnumIOSuperPageLevels < x86KSnumIOPTLevels - 2 &&
+            (sllps_bitmask & BIT(x86KSnumIOSuperPageLevels))) {
+        x86KSnumIOSuperPageLevels++;
+    }
+    printf("IOMMU: Using %d superpage levels\n", x86KSnumIOSuperPageLevels);
+
     vtd_create_root_table();
 
     for (bus = 0; bus < 256; bus++) {
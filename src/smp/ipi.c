@@ -14,6 +14,7 @@
 #include <mode/smp/ipi.h>
 #include <smp/ipi.h>
 #include <smp/lock.h>
+#include <model/kernel_stats.h>
 
 #ifdef ENABLE_SMP_SUPPORT
 /* This function switches the core it is called on to the idle thread,
@@ -75,6 +76,7 @@ void ipiStallCoreCallback(bool_t irqPath)
 
 void handleIPI(irq_t irq, bool_t irqPath)
 {
+    KERNEL_STATS_INC(seL4_KernelStats_IPIsReceived);
     if (irq == irq_remote_call_ipi) {
         handleRemoteCall(remoteCall, get_ipi_arg(0), get_ipi_arg(1), get_ipi_arg(2), irqPath);
     } else if (irq == irq_reschedule_ipi) {
@@ -92,6 +94,7 @@ void doRemoteMaskOp(IpiRemoteCall_t func, word_t data1, word_t data2, word_t dat
     /* this may happen, e.g. the caller tries to map a pagetable in
      * newly created PD which has not been run yet. Guard against them! */
     if (mask != 0) {
+        KERNEL_STATS_ADD(seL4_KernelStats_IPIsSent, popcountl(mask));
         init_ipi_args(func, data1, data2, data3, mask);
 
         /* make sure no resource access passes from this point */
@@ -106,6 +109,7 @@ void doMaskReschedule(word_t mask)
     /* make sure the current core is not set in the mask */
     mask &= ~BIT(getCurrentCPUIndex());
     if (mask != 0) {
+        KERNEL_STATS_ADD(seL4_KernelStats_IPIsSent, popcountl(mask));
         ipi_send_mask(irq_reschedule_ipi, mask, false);
     }
 }